@@ -1,5 +1,11 @@
 #include <Config/yjcServer.h>
+#include <atomic>
 #include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 using namespace yjcServer;
 
@@ -7,5 +13,106 @@ int main() {
     LogConfigInitializer::instance();
     spdlog::get("system_logger")->info("dinner");
     spdlog::get("task_logger")->info("dinner");
+
+    //快照: setValue之后旧快照不变，版本号和线程本地缓存随之更新
+    {
+        auto var = Config::Lookup<std::vector<int>>("test.snapshot", {1, 2},
+                                                    "snapshot test");
+        std::shared_ptr<const std::vector<int>> old = var->getSnapshot();
+        const uint64_t                          version = var->getVersion();
+        YJC_ASSERT(var->getLocal() == std::vector<int>({1, 2}));
+        var->setValue({1, 2});
+        YJC_ASSERT(var->getVersion() == version);
+        var->setValue({3});
+        YJC_ASSERT(var->getVersion() != version);
+        YJC_ASSERT(*old == std::vector<int>({1, 2}));
+        YJC_ASSERT(*var->getSnapshot() == std::vector<int>({3}));
+        YJC_ASSERT(var->getLocal() == std::vector<int>({3}));
+        YJC_ASSERT(var->getValue() == std::vector<int>({3}));
+    }
+    //同类型的参数各自缓存，交替读取时之前返回的引用仍然有效
+    {
+        auto a = Config::Lookup<std::vector<int>>("test.local_a", {1}, "");
+        auto b = Config::Lookup<std::vector<int>>("test.local_b", {2}, "");
+        const std::vector<int>& va = a->getLocal();
+        const std::vector<int>& vb = b->getLocal();
+        YJC_ASSERT(&a->getLocal() == &va && &b->getLocal() == &vb);
+        YJC_ASSERT(va == std::vector<int>({1}) && vb == std::vector<int>({2}));
+        b->setValue({4});
+        YJC_ASSERT(b->getLocal() == std::vector<int>({4}));
+        YJC_ASSERT(va == std::vector<int>({1}));
+    }
+
+    //读线程在写的同时读，每次读到的都是某一次完整写入的值
+    {
+        auto var = Config::Lookup<std::vector<int>>("test.concurrent",
+                                                    {0, 0, 0}, "");
+        std::atomic<bool>        stop = false;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 2; ++t) {
+            readers.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    const std::vector<int>& value = var->getLocal();
+                    YJC_ASSERT(value.size() == 3 && value[0] == value[1] &&
+                               value[1] == value[2]);
+                }
+            });
+        }
+        for (int i = 1; i <= 10000; ++i) {
+            var->setValue({i, i, i});
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        YJC_ASSERT(var->getLocal() == std::vector<int>({10000, 10000, 10000}));
+    }
+    //嵌套容器直接从YAML节点转换，字符串转换的结果相同
+    {
+        using Routes = std::map<std::string, std::vector<std::set<int>>>;
+        auto var = Config::Lookup<Routes>("test.routes", {}, "");
+        Config::LoadFromYaml(YAML::Load(
+            "test: {routes: {a: [[1, 2], [3]], b: [[]], c: []}}"));
+        const Routes expected = {{"a", {{1, 2}, {3}}}, {"b", {{}}}, {"c", {}}};
+        YJC_ASSERT(var->getValue() == expected);
+        var->setValue({});
+        YJC_ASSERT(var->fromString(var->toString()) && var->getValue().empty());
+        YJC_ASSERT(var->fromString("{a: [[1, 2], [3]], b: [[]], c: []}"));
+        YJC_ASSERT(var->getValue() == expected);
+    }
+    //句柄: 同一个名称得到同一个参数，类型不匹配时为空；注册表扩容时其他线程照常查找
+    {
+        auto handle = Config::LookupHandle<int>("test.handle", 1, "");
+        YJC_ASSERT(handle && handle->getValue() == 1);
+        YJC_ASSERT(Config::LookupHandle<int>("test.handle").get() ==
+                   handle.get());
+        YJC_ASSERT(Config::Lookup<int>("test.handle").get() == handle.get());
+        YJC_ASSERT(!Config::LookupHandle<std::string>("test.handle"));
+        YJC_ASSERT(!Config::LookupHandle<int>("test.missing"));
+
+        std::atomic<bool>        stop = false;
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 2; ++t) {
+            readers.emplace_back([&] {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto found = Config::LookupHandle<int>("test.handle");
+                    YJC_ASSERT(found.get() == handle.get());
+                }
+            });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            const std::string name = "test.registry." + std::to_string(i);
+            YJC_ASSERT(Config::LookupHandle<int>(name, i)->getValue() == i);
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        for (int i = 0; i < 1000; ++i) {
+            const std::string name = "test.registry." + std::to_string(i);
+            YJC_ASSERT(Config::LookupHandle<int>(name)->getValue() == i);
+        }
+    }
+    spdlog::info("config test passed");
     return 0;
-}
\ No newline at end of file
+}
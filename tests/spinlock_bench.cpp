@@ -0,0 +1,93 @@
+#include <Config/yjcServer.h>
+#include <thread/Spinlock.h>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * 自旋锁竞争测试: 1~N个线程在同一把锁上反复执行很短的临界区，运行固定时间
+ *   spinlock_bench [每组运行的毫秒数, 默认200] [最大线程数, 默认CPU数的2倍]
+ * 输出每组的吞吐量(百万次加锁/秒)和公平性:
+ *   jain  Jain公平指数 (sum x)^2 / (n * sum x^2)，1表示各线程加锁次数完全相同
+ *   min/max  加锁最少和最多的线程的次数之比
+ */
+
+using namespace yjcServer;
+
+struct alignas(64) PerThread {
+    uint64_t ops = 0;
+};
+
+template <class Lock>
+void run(const std::string& name, size_t threads,
+         std::chrono::milliseconds duration) {
+    Lock                   lock;
+    uint64_t               shared = 0;
+    std::atomic<bool>      start = false;
+    std::atomic<bool>      stop = false;
+    std::vector<PerThread> counters(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            uint64_t ops = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::lock_guard<Lock> guard(lock);
+                ++shared;
+                ++ops;
+            }
+            counters[t].ops = ops;
+        });
+    }
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(duration);
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    uint64_t total = 0;
+    uint64_t min_ops = UINT64_MAX;
+    uint64_t max_ops = 0;
+    double   square_sum = 0;
+    for (auto& counter : counters) {
+        total += counter.ops;
+        min_ops = std::min(min_ops, counter.ops);
+        max_ops = std::max(max_ops, counter.ops);
+        square_sum += static_cast<double>(counter.ops) * counter.ops;
+    }
+    YJC_ASSERT(shared == total);
+    const double jain = square_sum == 0 ? 0
+                                        : static_cast<double>(total) * total /
+                                              (threads * square_sum);
+    const double mops = total / 1e3 / duration.count();
+    spdlog::info("{:<10} threads={:<3} {:>8.2f} Mops/s  jain={:.3f}  "
+                 "min/max={:.3f}",
+                 name, threads, mops, jain,
+                 max_ops ? static_cast<double>(min_ops) / max_ops : 0.0);
+}
+
+int main(int argc, char** argv) {
+    LogConfigInitializer::instance();
+    const std::chrono::milliseconds duration(argc > 1 ? std::stoi(argv[1])
+                                                      : 200);
+    const size_t max_threads =
+        argc > 2 ? std::stoul(argv[2])
+                 : std::max<size_t>(2, 2 * std::thread::hardware_concurrency());
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < max_threads; n *= 2) {
+        counts.push_back(n);
+    }
+    counts.push_back(max_threads);
+    for (size_t threads : counts) {
+        run<TTASLock>("ttas", threads, duration);
+        run<TicketLock>("ticket", threads, duration);
+        run<MCSLock>("mcs", threads, duration);
+        run<std::mutex>("std::mutex", threads, duration);
+    }
+}
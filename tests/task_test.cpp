@@ -0,0 +1,147 @@
+#include <Config/yjcServer.h>
+#include <coroutine/CoThreadPool.h>
+#include <coroutine/async_channel.h>
+#include <coroutine/async_generator.h>
+#include <coroutine/async_latch.h>
+#include <coroutine/async_mutex.h>
+#include <coroutine/async_semaphore.h>
+#include <coroutine/frame_allocator.h>
+#include <coroutine/sync_wait.h>
+#include <coroutine/task.h>
+#include <coroutine/task_group.h>
+#include <coroutine/when_all.h>
+#include <coroutine/when_any.h>
+#include <thread>
+
+using namespace yjcServer;
+
+task<int> add(int a, int b) {
+    co_return a + b;
+}
+
+task<> sum(int n, int& out) {
+    for (int i = 0; i < n; i++) {
+        out = co_await add(out, 1);
+    }
+}
+
+task<> combinators(int& out) {
+    auto [a, b, c] = co_await when_all(add(1, 2), add(3, 4), sum(5, out));
+    YJC_ASSERT(a == 3 && b == 7);
+
+    std::vector<task<int>> tasks;
+    for (int i = 0; i < 10; i++) {
+        tasks.push_back(add(i, 0));
+    }
+    std::vector<int> res = co_await when_all(std::move(tasks));
+    YJC_ASSERT(res.size() == 10 && res[9] == 9);
+
+    auto first = co_await when_any(add(1, 1), add(2, 2));
+    YJC_ASSERT(first.index == 0 && first.value == 2);
+
+    task_group group;
+    for (int i = 0; i < 100; i++) {
+        group.spawn(sum(1, out));
+    }
+    co_await group.join();
+}
+
+async_generator<int> range(int n) {
+    for (int i = 0; i < n; i++) {
+        co_yield co_await add(i, 0);
+    }
+}
+
+task<int> consume() {
+    int total = 0;
+    auto gen = range(10);
+    for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it) {
+        total += *it;
+    }
+    co_await for_each(range(10), [&](int& v) { total += v; });
+    co_return total;
+}
+
+async_mutex     mutex;
+async_semaphore semaphore(2);
+async_latch     latch(100);
+int             shared_count = 0;
+
+task<> locked_add(CoThreadPool& pool) {
+    co_await pool.schedule();
+    {
+        auto guard = co_await mutex.scoped_lock();
+        ++shared_count;
+    }
+    co_await semaphore.acquire();
+    YJC_ASSERT(semaphore.available() >= 0);
+    semaphore.release();
+    latch.count_down();
+}
+
+task<int> channel_sum() {
+    async_channel<int> channel(4);
+    task_group         group;
+    for (int p = 0; p < 4; p++) {
+        group.spawn([](async_channel<int>& ch) -> task<> {
+            for (int i = 1; i <= 100; i++) {
+                co_await ch.send(i);
+            }
+        }(channel));
+    }
+    int total = 0;
+    for (int i = 0; i < 400; i++) {
+        total += *co_await channel.recv();
+    }
+    co_await group.join();
+    channel.close();
+    YJC_ASSERT(!(co_await channel.recv()).has_value());
+    co_return total;
+}
+
+int main() {
+    LogConfigInitializer::instance();
+
+    //同线程分配/释放，帧被空闲链表复用
+    int  out = 0;
+    sync_wait(sum(10000, out));
+    YJC_ASSERT(out == 10000);
+    spdlog::info("out = {}, cached blocks = {}", out,
+                 frame_allocator::cached_blocks());
+
+    //主线程分配、其他线程释放，帧回到主线程缓存的远程释放栈
+    std::vector<task<int>> tasks;
+    for (int i = 0; i < 100; i++) {
+        tasks.push_back(add(i, i));
+    }
+    const size_t before = frame_allocator::cached_blocks();
+    std::thread([&] { tasks.clear(); }).join();
+    auto again = add(1, 2);
+    spdlog::info("cached blocks before remote free = {}, after = {}", before,
+                 frame_allocator::cached_blocks());
+    YJC_ASSERT(frame_allocator::cached_blocks() >= before + 99);
+
+    //when_all/when_any/task_group
+    out = 0;
+    sync_wait(combinators(out));
+    spdlog::info("combinators out = {}", out);
+    YJC_ASSERT(out == 105);
+
+    //异步生成器
+    YJC_ASSERT(sync_wait(consume()) == 90);
+
+    //在线程池上执行，主线程阻塞等待
+    CoThreadPool co_pool;
+    YJC_ASSERT(sync_wait(co_pool, add(20, 22)) == 42);
+
+    //协程同步原语
+    std::vector<task<>> adders;
+    for (int i = 0; i < 100; i++) {
+        adders.push_back(locked_add(co_pool));
+    }
+    sync_wait(when_all(std::move(adders)));
+    sync_wait([]() -> task<> { co_await latch.wait(); }());
+    spdlog::info("shared_count = {}", shared_count);
+    YJC_ASSERT(shared_count == 100);
+    YJC_ASSERT(sync_wait(channel_sum()) == 4 * 5050);
+}
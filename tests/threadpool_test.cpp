@@ -1,5 +1,7 @@
 #include <Config/yjcServer.h>
+#include <thread/Parallel.h>
 #include <thread/ThreadPool.h>
+#include <random>
 
 using namespace yjcServer;
 
@@ -16,13 +18,302 @@ void fun1() {
     }
 }
 
+std::atomic<long long> leaves = 0;
+
+//工作线程内递归提交，任务进入本地队列并被其他线程窃取
+void spawn_tree(ThreadPool* pool, int depth) {
+    if (depth == 0) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pool->push_task(spawn_tree, pool, depth - 1);
+    pool->push_task(spawn_tree, pool, depth - 1);
+}
+
+std::atomic<int> moved_sum = 0;
+std::atomic<int> warmed_threads = 0;
+
+void take_unique(std::unique_ptr<int> value) {
+    moved_sum.fetch_add(*value, std::memory_order_relaxed);
+}
+
 int main() {
     LogConfigInitializer::instance();
     ThreadPool* pool = new ThreadPool;
     for (size_t i = 0; i < 5; i++) {
         pool->push_task([] { fun1(); });
     }
+    //只能移动的捕获和参数
+    for (int i = 0; i < 100; ++i) {
+        pool->push_task([value = std::make_unique<int>(i)] {
+            moved_sum.fetch_add(*value, std::memory_order_relaxed);
+        });
+        pool->push_task(take_unique, std::make_unique<int>(i));
+    }
     pool->print(spdlog::get("task_logger"));
     delete pool;
+    YJC_ASSERT(moved_sum == 2 * 4950);
+
+    //submit取结果，批量提交后只等自己这一批
+    ThreadPool*      batch_pool = new ThreadPool(4);
+    std::future<int> answer =
+        batch_pool->submit([](int x) { return x * 2; }, 21);
+    std::future<void> failed =
+        batch_pool->submit([] { throw std::runtime_error("boom"); });
+    YJC_ASSERT(answer.get() == 42);
+    bool thrown = false;
+    try {
+        failed.get();
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    YJC_ASSERT(thrown);
+    for (auto mode : {ThreadPoolMode::shared, ThreadPoolMode::work_stealing,
+                      ThreadPoolMode::mpmc}) {
+        ThreadPool                         mode_pool(4, mode);
+        std::atomic<int>                   done = 0;
+        std::vector<std::function<void()>> jobs(10000, [&done] {
+            done.fetch_add(1, std::memory_order_relaxed);
+        });
+        WaitGroup group;
+        mode_pool.push_tasks(jobs, group);
+        group.wait();
+        YJC_ASSERT(done == 10000);
+        mode_pool.push_tasks(std::move(jobs));
+    }
+    delete batch_pool;
+
+    //并行算法，嵌套调用不会死锁
+    ThreadPool       algo_pool(4);
+    std::vector<int> squares(100000);
+    parallel_for(algo_pool, size_t{0}, squares.size(),
+                 [&](size_t i) { squares[i] = static_cast<int>(i % 1000); });
+    long long total = parallel_reduce(
+        algo_pool, squares, 0LL, [](int v) { return static_cast<long long>(v); },
+        std::plus<>{});
+    YJC_ASSERT(total == 100LL * 499500);
+    std::vector<long long> doubled(squares.size());
+    parallel_transform(algo_pool, squares.begin(), squares.end(),
+                       doubled.begin(), [](int v) { return 2LL * v; });
+    YJC_ASSERT(doubled[12345] == 2 * 345);
+    std::vector<int> shuffled(1 << 20);
+    std::mt19937     rng(42);
+    for (auto& v : shuffled) {
+        v = static_cast<int>(rng());
+    }
+    algo_pool
+        .submit([&algo_pool, &shuffled] {
+            parallel_sort(algo_pool, shuffled.begin(), shuffled.end());
+        })
+        .get();
+    YJC_ASSERT(std::is_sorted(shuffled.begin(), shuffled.end()));
+    bool caught = false;
+    try {
+        parallel_for(algo_pool, 0, 1000, [](int i) {
+            if (i == 500) {
+                throw std::runtime_error("chunk failed");
+            }
+        });
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    YJC_ASSERT(caught);
     spdlog::info("count = {}.", count);
-}
\ No newline at end of file
+
+    //优先级通道: 唯一的线程先被占住，之后按权重出队，过期任务被丢弃
+    {
+        ThreadPool        lane_pool(1, ThreadPoolMode::shared);
+        WaitGroup         group;
+        std::vector<char> order;
+        std::atomic<bool> release = false;
+        bool              missed = false;
+        lane_pool.push_task([&release] {
+            while (!release.load()) {
+                std::this_thread::yield();
+            }
+        });
+        auto record = [&](char c) {
+            order.push_back(c);
+            group.done();
+        };
+        const auto past = TaskOptions::Clock::now() - std::chrono::seconds(1);
+        group.add(13);
+        for (int i = 0; i < 4; ++i) {
+            lane_pool.push_task({TaskPriority::background}, record, 'b');
+        }
+        for (int i = 0; i < 8; ++i) {
+            lane_pool.push_task({TaskPriority::critical}, record, 'c');
+        }
+        lane_pool.push_task({TaskPriority::critical, past}, record, 'x');
+        lane_pool.push_task({TaskPriority::normal, past, false}, [&] {
+            missed = ThreadPool::DeadlineMissed();
+            group.done();
+        });
+        release = true;
+        group.wait();
+        YJC_ASSERT(order.size() == 12);
+        YJC_ASSERT(std::count(order.begin(), order.begin() + 8, 'c') >= 6);
+        YJC_ASSERT(std::find(order.begin(), order.end(), 'x') == order.end());
+        YJC_ASSERT(lane_pool.expired_count() == 1);
+        YJC_ASSERT(missed);
+    }
+
+    //同一通道内不断有截止时间任务到来，没有截止时间的任务仍按提交顺序出队
+    {
+        TaskLanes        lanes;
+        TaskLanes::Entry entry;
+        const auto soon = TaskOptions::Clock::now() + std::chrono::hours(1);
+        for (int i = 0; i < 4; ++i) {
+            lanes.push(UniqueTask([] {}));
+        }
+        std::vector<uint64_t> fifo_order;
+        for (int i = 0; i < 40; ++i) {
+            lanes.push(UniqueTask([] {}), {TaskPriority::normal, soon});
+            YJC_ASSERT(lanes.pop(entry));
+            if (entry.deadline == TaskOptions::Clock::time_point::max()) {
+                fifo_order.push_back(entry.seq);
+            }
+        }
+        YJC_ASSERT(fifo_order == std::vector<uint64_t>({0, 1, 2, 3}));
+        YJC_ASSERT(lanes.size() == 4);
+    }
+
+    //弹性伸缩: 任务阻塞、排队变长时扩容，空闲超时后退回下限；运行时调整线程数
+    auto wait_threads = [](ThreadPool& target, size_t expected) {
+        for (int i = 0; i < 400 && target.thread_count() != expected; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return target.thread_count() == expected;
+    };
+    {
+        ThreadPool elastic_pool(1, ThreadPoolMode::shared, AffinityPolicy::none,
+                                {1, 4, std::chrono::microseconds(500),
+                                 std::chrono::milliseconds(50)});
+        YJC_ASSERT(elastic_pool.elastic());
+        WaitGroup group;
+        for (int i = 0; i < 40; ++i) {
+            group.add();
+            elastic_pool.push_task([&group] {
+                WaitGroup::Guard guard(group);
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        const size_t grown = elastic_pool.thread_count();
+        group.wait();
+        spdlog::info("elastic grown to {}, queue wait {}us.", grown,
+                     elastic_pool.queue_wait().count() / 1000);
+        YJC_ASSERT(grown > 1 && grown <= 4);
+        YJC_ASSERT(wait_threads(elastic_pool, 1));
+        elastic_pool.resize(3);
+        YJC_ASSERT(elastic_pool.thread_count() == 3);
+    }
+    {
+        ThreadPool fixed_pool(4, ThreadPoolMode::work_stealing,
+                              AffinityPolicy::none, ElasticOptions{});
+        YJC_ASSERT(!fixed_pool.elastic());
+        fixed_pool.resize(2);
+        YJC_ASSERT(wait_threads(fixed_pool, 2));
+        leaves = 0;
+        fixed_pool.push_task(spawn_tree, &fixed_pool, 10);
+        fixed_pool.resize(3);
+        YJC_ASSERT(fixed_pool.thread_count() == 3);
+    }
+    YJC_ASSERT(leaves == (1 << 10));
+    leaves = 0;
+    {
+        //没有指定线程数的线程池跟随global.thread_pool_size
+        ThreadPool   config_pool(0, ThreadPoolMode::shared, AffinityPolicy::none,
+                                 ElasticOptions{});
+        GlobalConfig config = GetGlobalConfig()->getValue();
+        const size_t old_size = config.thread_pool_size;
+        config.thread_pool_size = config_pool.thread_count() == 3 ? 2 : 3;
+        GetGlobalConfig()->setValue(config);
+        YJC_ASSERT(wait_threads(config_pool, config.thread_pool_size));
+        config.thread_pool_size = old_size;
+        GetGlobalConfig()->setValue(config);
+    }
+    {
+        //预热在构造函数返回前完成，每个工作线程执行一次注册的预热函数
+        Thread::AddWarmup([] { warmed_threads.fetch_add(1); });
+        GlobalConfig config = GetGlobalConfig()->getValue();
+        config.thread_pool_warmup = true;
+        GetGlobalConfig()->setValue(config);
+        ThreadPool warm_pool(4, ThreadPoolMode::work_stealing,
+                             AffinityPolicy::none, ElasticOptions{});
+        YJC_ASSERT(warmed_threads == 4);
+        config.thread_pool_warmup = false;
+        GetGlobalConfig()->setValue(config);
+    }
+
+    //统计快照: 各线程的任务数合计等于提交数，执行时间落在sleep时长之上的桶里
+    {
+        ThreadPool        stats_pool(2, ThreadPoolMode::work_stealing,
+                                     AffinityPolicy::none, ElasticOptions{});
+        WaitGroup         group;
+        std::vector<std::function<void()>> sleeps(100, [] {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        });
+        stats_pool.push_tasks(sleeps, group);
+        group.wait();
+        ThreadPoolSnapshot snap = stats_pool.snapshot();
+        for (int i = 0; i < 200 && snap.tasks != 100; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            snap = stats_pool.snapshot();
+        }
+        stats_pool.print(spdlog::get("task_logger"));
+        YJC_ASSERT(snap.tasks == 100);
+        YJC_ASSERT(snap.workers.size() == 2);
+        YJC_ASSERT(snap.queue_wait.count == 100);
+        YJC_ASSERT(snap.run_time.percentile(0.5) >=
+                   std::chrono::microseconds(100));
+        YJC_ASSERT(snap.queued == 0);
+    }
+
+    //绑核: compact/scatter每个线程一个CPU，numa每个线程一个节点
+    YJC_ASSERT(ParseCpuList("0-2,5,4") == std::vector<int>({0, 1, 2, 4, 5}));
+    const size_t cpu_count = CpuTopology::Instance().cpus().size();
+    YJC_ASSERT(cpu_count > 0);
+    for (auto policy : {AffinityPolicy::compact, AffinityPolicy::scatter,
+                        AffinityPolicy::numa}) {
+        auto plan = PlanAffinity(policy, 4, {}, false);
+        for (auto& cpus : plan) {
+            YJC_ASSERT(!cpus.empty());
+        }
+        if (policy != AffinityPolicy::numa && cpu_count > 1) {
+            YJC_ASSERT(plan[0][0] != plan[1][0]);
+        }
+    }
+    ThreadPool* stealing_pool =
+        new ThreadPool(4, ThreadPoolMode::work_stealing, AffinityPolicy::scatter);
+    stealing_pool->push_task(spawn_tree, stealing_pool, 16);
+    delete stealing_pool;
+    spdlog::info("leaves = {}.", leaves.load());
+    YJC_ASSERT(leaves == (1 << 16));
+
+    //多个外部线程同时向无锁环形队列提交
+    std::atomic<long long> sum = 0;
+    ThreadPool*            ring_pool = new ThreadPool(4, ThreadPoolMode::mpmc);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 4; ++p) {
+        producers.emplace_back([ring_pool, &sum] {
+            for (int i = 0; i < 100000; ++i) {
+                ring_pool->push_task([&sum, i] {
+                    sum.fetch_add(i, std::memory_order_relaxed);
+                });
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    //递归提交的任务远多于队列容量，多出的溢出到加锁队列
+    leaves = 0;
+    ring_pool->push_task(spawn_tree, ring_pool, 16);
+    delete ring_pool;
+    spdlog::info("sum = {}, leaves = {}.", sum.load(), leaves.load());
+    YJC_ASSERT(sum == 4LL * (99999LL * 100000 / 2));
+    YJC_ASSERT(leaves == (1 << 16));
+}
@@ -0,0 +1,178 @@
+#include <Config/yjcServer.h>
+#include <io/websocket.h>
+#include <string>
+#include <vector>
+
+using namespace yjcServer;
+
+static constexpr std::array<uint8_t, 4> mask_key = {0x12, 0x34, 0x56, 0x78};
+
+/// @brief 按客户端的格式编码一帧，masked为false时不带掩码
+std::string make_frame(ws_opcode opcode, std::string_view payload,
+                       bool fin = true, bool masked = true) {
+    std::string frame;
+    frame.push_back(
+        static_cast<char>((fin ? 0x80 : 0) | static_cast<uint8_t>(opcode)));
+    const uint8_t mask_bit = masked ? 0x80 : 0;
+    const size_t  len = payload.size();
+    if (len < 126) {
+        frame.push_back(static_cast<char>(mask_bit | len));
+    } else if (len <= 0xFFFF) {
+        frame.push_back(static_cast<char>(mask_bit | 126));
+        frame.push_back(static_cast<char>(len >> 8));
+        frame.push_back(static_cast<char>(len));
+    } else {
+        frame.push_back(static_cast<char>(mask_bit | 127));
+        for (size_t i = 0; i < 8; ++i) {
+            frame.push_back(static_cast<char>(uint64_t(len) >> (56 - 8 * i)));
+        }
+    }
+    if (masked) {
+        frame.append(reinterpret_cast<const char*>(mask_key.data()), 4);
+    }
+    for (size_t i = 0; i < len; ++i) {
+        frame.push_back(masked ? static_cast<char>(payload[i] ^ mask_key[i & 3])
+                               : payload[i]);
+    }
+    return frame;
+}
+
+std::string make_payload(size_t len) {
+    std::string payload(len, '\0');
+    for (size_t i = 0; i < len; ++i) {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    return payload;
+}
+
+struct received {
+    ws_opcode   opcode;
+    std::string payload;
+};
+
+/// @brief 把一块数据交给conn，收到的消息追加到out，buf在解析时会被原地去掩码
+bool feed(ws_connection& conn, std::string buf, std::vector<received>& out) {
+    return conn.feed({buf.data(), buf.size()},
+                     [&](const ws_connection::message& msg) {
+                         out.push_back({msg.opcode,
+                                        std::string(msg.payload.data(),
+                                                    msg.payload.size())});
+                     });
+}
+
+int main() {
+    LogConfigInitializer::instance();
+
+    //长度编码的边界: 7位/16位/64位，带掩码和不带掩码的帧头长度
+    for (size_t len : {0, 1, 125, 126, 127, 65535, 65536, 70000}) {
+        const std::string payload = make_payload(len);
+        const size_t      len_bytes = len < 126 ? 0 : len <= 0xFFFF ? 2 : 8;
+        for (bool masked : {true, false}) {
+            const std::string frame =
+                make_frame(ws_opcode::binary, payload, true, masked);
+            ws_frame_header header;
+            YJC_ASSERT(ws_parse_frame_header(frame, header) ==
+                       ws_parse_status::ok);
+            YJC_ASSERT(header.payload_len == len && header.masked == masked);
+            YJC_ASSERT(header.header_len == 2 + len_bytes + (masked ? 4 : 0));
+            YJC_ASSERT(ws_parse_frame_header(
+                           {frame.data(), header.header_len - 1}, header) ==
+                       ws_parse_status::incomplete);
+        }
+        //服务端只接受带掩码的帧
+        ws_connection         conn;
+        std::vector<received> messages;
+        YJC_ASSERT(
+            feed(conn, make_frame(ws_opcode::binary, payload), messages));
+        YJC_ASSERT(messages.size() == 1 &&
+                   messages[0].opcode == ws_opcode::binary &&
+                   messages[0].payload == payload);
+        ws_connection unmasked;
+        YJC_ASSERT(!feed(unmasked,
+                         make_frame(ws_opcode::binary, payload, true, false),
+                         messages));
+
+        //出站帧不带掩码，帧头和上面的编码一致
+        ws_writer writer;
+        YJC_ASSERT(writer.add_frame(ws_opcode::text, payload));
+        const iovec& head = writer.iovecs()[0];
+        ws_frame_header header;
+        YJC_ASSERT(ws_parse_frame_header(
+                       {static_cast<const char*>(head.iov_base), head.iov_len},
+                       header) == ws_parse_status::ok);
+        YJC_ASSERT(!header.masked && header.payload_len == len &&
+                   header.header_len == 2 + len_bytes);
+    }
+
+    //一帧分在两个缓冲区里，中间连接空闲调用shrink，已收到的部分不能丢
+    {
+        const std::string payload = make_payload(1000);
+        const std::string frame = make_frame(ws_opcode::text, payload);
+        for (size_t split : {1, 3, 7, 8, 9, 500, 1007}) {
+            ws_connection         conn;
+            std::vector<received> messages;
+            YJC_ASSERT(feed(conn, frame.substr(0, split), messages));
+            YJC_ASSERT(messages.empty());
+            conn.shrink();
+            YJC_ASSERT(feed(conn, frame.substr(split), messages));
+            YJC_ASSERT(messages.size() == 1 &&
+                       messages[0].opcode == ws_opcode::text &&
+                       messages[0].payload == payload);
+            conn.shrink();
+            YJC_ASSERT(feed(conn, frame, messages));
+            YJC_ASSERT(messages.size() == 2 && messages[1].payload == payload);
+        }
+    }
+
+    //分片消息之间穿插控制帧，控制帧先交付，分片继续拼接
+    {
+        ws_connection         conn;
+        std::vector<received> messages;
+        YJC_ASSERT(feed(conn, make_frame(ws_opcode::text, "Hel", false),
+                        messages));
+        YJC_ASSERT(messages.empty());
+        conn.shrink();
+        const std::string ping = make_frame(ws_opcode::ping, "ping");
+        YJC_ASSERT(feed(conn, ping.substr(0, 4), messages));
+        YJC_ASSERT(feed(conn,
+                        ping.substr(4) +
+                            make_frame(ws_opcode::continuation, "lo", true),
+                        messages));
+        YJC_ASSERT(messages.size() == 2);
+        YJC_ASSERT(messages[0].opcode == ws_opcode::ping &&
+                   messages[0].payload == "ping");
+        YJC_ASSERT(messages[1].opcode == ws_opcode::text &&
+                   messages[1].payload == "Hello");
+        //控制帧不能分片，不在分片中时不能出现continuation
+        YJC_ASSERT(
+            !feed(conn, make_frame(ws_opcode::ping, "", false), messages));
+        ws_connection other;
+        YJC_ASSERT(!feed(other, make_frame(ws_opcode::continuation, "x"),
+                         messages));
+    }
+
+    //消息长度上限: 包括所有分片，完整落在一个缓冲区内的帧同样检查
+    {
+        std::vector<received> messages;
+        ws_connection         conn(100);
+        const std::string head =
+            make_frame(ws_opcode::binary, make_payload(60), false);
+        YJC_ASSERT(feed(
+            conn, make_frame(ws_opcode::binary, make_payload(100)), messages));
+        YJC_ASSERT(feed(
+            conn, head + make_frame(ws_opcode::continuation, make_payload(40)),
+            messages));
+        YJC_ASSERT(messages.size() == 2 && messages[1].payload.size() == 100);
+
+        ws_connection whole(100);
+        YJC_ASSERT(!feed(
+            whole, make_frame(ws_opcode::binary, make_payload(101)), messages));
+        ws_connection fragmented(100);
+        YJC_ASSERT(feed(fragmented, head, messages));
+        YJC_ASSERT(!feed(fragmented,
+                         make_frame(ws_opcode::continuation, make_payload(41)),
+                         messages));
+    }
+    spdlog::info("websocket test passed");
+    return 0;
+}
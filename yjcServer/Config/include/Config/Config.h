@@ -1,8 +1,10 @@
 #pragma once
 
+#include <Config/ConfigRegistry.h>
 #include <Config/util.h>
 #include <spdlog/spdlog.h>
 #include <yaml-cpp/yaml.h>
+#include <atomic>
 #include <functional>
 #include <list>
 #include <map>
@@ -11,6 +13,7 @@
 #include <shared_mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <typeinfo>
 #include <unordered_map>
 #include <unordered_set>
@@ -58,9 +61,19 @@ public:
     /// @brief 从字符串初始化值
     virtual bool fromString(const std::string&) = 0;
 
+    /// @brief 从YAML节点初始化值，不经过字符串
+    virtual bool fromYaml(const YAML::Node&) = 0;
+
     /// @brief 返回配置参数的类型名称
     virtual std::string getTypeName() = 0;
 
+protected:
+    /// @brief 新的版本号，所有配置参数共用一个计数器，不同参数的版本号不会相同
+    static uint64_t NextVersion() {
+        static std::atomic<uint64_t> s_version{0};
+        return s_version.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
 protected:
     std::string m_name;         //配置参数名称
     std::string m_description;  //配置参数描述
@@ -87,21 +100,43 @@ public:
     }
 };
 
+/// @brief 类型转换模板类偏特化，YAML::Node直接转换成T，不经过字符串
+/// 标量节点取出字符串转换；其他节点(只实现了从字符串转换的自定义类型)序列化后转换。
+/// 容器和自定义类型特化这个模板，直接遍历子节点，整个文档只解析一次
+template <class T>
+class LexicalCast<YAML::Node, T> {
+public:
+    T operator()(const YAML::Node& node) {
+        if (node.IsScalar()) {
+            return LexicalCast<std::string, T>()(node.Scalar());
+        }
+        std::stringstream ss;
+        ss << node;
+        return LexicalCast<std::string, T>()(ss.str());
+    }
+};
+
+/// @brief 类型转换模板类偏特化，YAML::Node转化为std::vector<T>
+template <class T>
+class LexicalCast<YAML::Node, std::vector<T>> {
+public:
+    std::vector<T> operator()(const YAML::Node& node) {
+        std::vector<T> vec;
+        vec.reserve(node.size());
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            vec.push_back(LexicalCast<YAML::Node, T>()(*it));
+        }
+        return vec;
+    }
+};
+
 /// @brief 类型转换模板类偏特化，yaml String转化为std::vector<T>
 /// @tparam T
 template <class T>
 class LexicalCast<std::string, std::vector<T>> {
 public:
     std::vector<T> operator()(const std::string& v) {
-        YAML::Node        node = YAML::Load(v);
-        std::vector<T>    vec;
-        std::stringstream ss;
-        for (size_t i = 0; i < node.size(); ++i) {
-            ss.str("");
-            ss << node[i];
-            vec.push_back(LexicalCast<std::string, T>()(ss.str()));
-        }
-        return vec;
+        return LexicalCast<YAML::Node, std::vector<T>>()(YAML::Load(v));
     }
 };
 
@@ -120,20 +155,25 @@ public:
     }
 };
 
+/// @brief 类型转换模板偏特化(YAML::Node转化为list<T>)
+template <class T>
+class LexicalCast<YAML::Node, std::list<T>> {
+public:
+    std::list<T> operator()(const YAML::Node& node) {
+        std::list<T> vec;
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            vec.push_back(LexicalCast<YAML::Node, T>()(*it));
+        }
+        return vec;
+    }
+};
+
 /// @brief 类型转换模板偏特化(yaml string转化为list<T>)
 template <class T>
 class LexicalCast<std::string, std::list<T>> {
 public:
     std::list<T> operator()(const std::string& v) {
-        YAML::Node        node = YAML::Load(v);
-        std::list<T>      vec;
-        std::stringstream ss;
-        for (size_t i = 0; i < node.size(); ++i) {
-            ss.str("");
-            ss << node[i];
-            vec.push_back(LexicalCast<std::string, T>()(ss.str()));
-        }
-        return vec;
+        return LexicalCast<YAML::Node, std::list<T>>()(YAML::Load(v));
     }
 };
 
@@ -153,24 +193,31 @@ public:
 };
 
 /**
- * @brief 类型转换模板类片特化(YAML String 转换成 std::set<T>)
+ * @brief 类型转换模板类片特化(YAML::Node 转换成 std::set<T>)
  */
 template <class T>
-class LexicalCast<std::string, std::set<T>> {
+class LexicalCast<YAML::Node, std::set<T>> {
 public:
-    std::set<T> operator()(const std::string& v) {
-        YAML::Node           node = YAML::Load(v);
+    std::set<T> operator()(const YAML::Node& node) {
         typename std::set<T> vec;
-        std::stringstream    ss;
-        for (size_t i = 0; i < node.size(); ++i) {
-            ss.str("");
-            ss << node[i];
-            vec.insert(LexicalCast<std::string, T>()(ss.str()));
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            vec.insert(LexicalCast<YAML::Node, T>()(*it));
         }
         return vec;
     }
 };
 
+/**
+ * @brief 类型转换模板类片特化(YAML String 转换成 std::set<T>)
+ */
+template <class T>
+class LexicalCast<std::string, std::set<T>> {
+public:
+    std::set<T> operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, std::set<T>>()(YAML::Load(v));
+    }
+};
+
 /**
  * @brief 类型转换模板类片特化(std::set<T> 转换成 YAML String)
  */
@@ -189,24 +236,31 @@ public:
 };
 
 /**
- * @brief 类型转换模板类片特化(YAML String 转换成 std::unordered_set<T>)
+ * @brief 类型转换模板类片特化(YAML::Node 转换成 std::unordered_set<T>)
  */
 template <class T>
-class LexicalCast<std::string, std::unordered_set<T>> {
+class LexicalCast<YAML::Node, std::unordered_set<T>> {
 public:
-    std::unordered_set<T> operator()(const std::string& v) {
-        YAML::Node                     node = YAML::Load(v);
+    std::unordered_set<T> operator()(const YAML::Node& node) {
         typename std::unordered_set<T> vec;
-        std::stringstream              ss;
-        for (size_t i = 0; i < node.size(); ++i) {
-            ss.str("");
-            ss << node[i];
-            vec.insert(LexicalCast<std::string, T>()(ss.str()));
+        for (auto it = node.begin(); it != node.end(); ++it) {
+            vec.insert(LexicalCast<YAML::Node, T>()(*it));
         }
         return vec;
     }
 };
 
+/**
+ * @brief 类型转换模板类片特化(YAML String 转换成 std::unordered_set<T>)
+ */
+template <class T>
+class LexicalCast<std::string, std::unordered_set<T>> {
+public:
+    std::unordered_set<T> operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, std::unordered_set<T>>()(YAML::Load(v));
+    }
+};
+
 /**
  * @brief 类型转换模板类片特化(std::unordered_set<T> 转换成 YAML String)
  */
@@ -225,26 +279,34 @@ public:
 };
 
 /**
- * @brief 类型转换模板类片特化(YAML String 转换成 std::map<std::string, T>)
+ * @brief 类型转换模板类片特化(YAML::Node 转换成 std::map<std::string, T>)
  */
 template <class T>
-class LexicalCast<std::string, std::map<std::string, T>> {
+class LexicalCast<YAML::Node, std::map<std::string, T>> {
 public:
-    std::map<std::string, T> operator()(const std::string& v) {
-        YAML::Node                        node = YAML::Load(v);
+    std::map<std::string, T> operator()(const YAML::Node& node) {
         typename std::map<std::string, T> vec;
-        std::stringstream                 ss;
         for (auto it = node.begin(); it != node.end(); ++it) {
-            ss.str("");
-            ss << it->second;
-            vec.insert(
-                std::make_pair(it->first.Scalar(),
-                               LexicalCast<std::string, T>()(ss.str())));
+            vec.insert(std::make_pair(
+                it->first.Scalar(),
+                LexicalCast<YAML::Node, T>()(it->second)));
         }
         return vec;
     }
 };
 
+/**
+ * @brief 类型转换模板类片特化(YAML String 转换成 std::map<std::string, T>)
+ */
+template <class T>
+class LexicalCast<std::string, std::map<std::string, T>> {
+public:
+    std::map<std::string, T> operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, std::map<std::string, T>>()(
+            YAML::Load(v));
+    }
+};
+
 /**
  * @brief 类型转换模板类片特化(std::map<std::string, T> 转换成 YAML String)
  */
@@ -264,28 +326,38 @@ public:
 };
 
 /**
- * @brief 类型转换模板类片特化(YAML String 转换成
+ * @brief 类型转换模板类片特化(YAML::Node 转换成
  * std::unordered_map<std::string, T>)
  */
 template <class T>
-class LexicalCast<std::string, std::unordered_map<std::string, T>> {
+class LexicalCast<YAML::Node, std::unordered_map<std::string, T>> {
 public:
-    std::unordered_map<std::string, T> operator()(const std::string& v) {
-        YAML::Node                                  node = YAML::Load(v);
+    std::unordered_map<std::string, T> operator()(const YAML::Node& node) {
         typename std::unordered_map<std::string, T> vec;
-        std::stringstream                           ss;
+        vec.reserve(node.size());
         for (auto it = node.begin(); it != node.end(); ++it) {
-            ss.str("");
-            ss << it->second;
             vec.insert(std::make_pair(
                 it->first
                     .Scalar(),  //这里是因为第一个肯定是string，可以用scalar
-                LexicalCast<std::string, T>()(ss.str())));
+                LexicalCast<YAML::Node, T>()(it->second)));
         }
         return vec;
     }
 };
 
+/**
+ * @brief 类型转换模板类片特化(YAML String 转换成
+ * std::unordered_map<std::string, T>)
+ */
+template <class T>
+class LexicalCast<std::string, std::unordered_map<std::string, T>> {
+public:
+    std::unordered_map<std::string, T> operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, std::unordered_map<std::string, T>>()(
+            YAML::Load(v));
+    }
+};
+
 /**
  * @brief 类型转换模板类片特化(std::unordered_map<std::string, T> 转换成
  * YAML String)
@@ -310,13 +382,59 @@ public:
  *-----------------------------------------------------------
  */
 
+/// @brief 原子发布的不可变快照
+/// 和libstdc++的std::atomic<std::shared_ptr>一样，用一个锁位保护shared_ptr的拷贝(只是一次引用计数加一)。
+/// libstdc++ 12的load()以relaxed序释放锁位，和之后的store()没有同步关系，TSan会报告数据竞争，
+/// 这里释放锁位都用release序
+template <class T>
+class SnapshotCell {
+private:
+    mutable std::atomic<bool> m_locked{false};
+    std::shared_ptr<const T>  m_value;
+
+    void lock() const noexcept {
+        while (m_locked.exchange(true, std::memory_order_acquire)) {
+            while (m_locked.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void unlock() const noexcept {
+        m_locked.store(false, std::memory_order_release);
+    }
+
+public:
+    explicit SnapshotCell(std::shared_ptr<const T> value)
+        : m_value(std::move(value)) {}
+
+    std::shared_ptr<const T> load() const noexcept {
+        lock();
+        std::shared_ptr<const T> value = m_value;
+        unlock();
+        return value;
+    }
+
+    /// @brief 替换快照，旧快照在锁外释放
+    void store(std::shared_ptr<const T> value) noexcept {
+        lock();
+        m_value.swap(value);
+        unlock();
+    }
+};
+
 /// @brief 配置参数模板子类,保存对应类型的参数值
+/// 参数值是不可变的快照(shared_ptr<const T>)，setValue生成新快照后原子地替换，
+/// 读取不加读写锁: getSnapshot()只拷贝一次shared_ptr，getLocal()在线程本地缓存快照，
+/// 版本号没变时只读一次版本号，不增加引用计数，也不拷贝T。
 /// @tparam T 参数的具体类型
 /// @tparam FromStr 从std::string转换成T类型的仿函数
 /// @tparam ToStr 从T转换成std::string的仿函数
 ///  std::string 为YAML格式的字符串
+/// @tparam FromNode 从YAML::Node转换成T类型的仿函数
 template <class T, class FromStr = LexicalCast<std::string, T>,
-          class ToStr = LexicalCast<T, std::string>>
+          class ToStr = LexicalCast<T, std::string>,
+          class FromNode = LexicalCast<YAML::Node, T>>
 class ConfigVar : public ConfigVarBase {
 public:
     using ptr = std::shared_ptr<ConfigVar<T>>;
@@ -330,13 +448,15 @@ public:
     /// @param description 描述
     ConfigVar(const std::string& name, const T& default_value,
               const std::string& description = "")
-        : ConfigVarBase(name, description), m_val(default_value) {}
+        : ConfigVarBase(name, description),
+          m_snapshot(std::make_shared<const T>(default_value)),
+          m_version(NextVersion()),
+          m_slot(NextSlot()) {}
 
     /// @brief 参数值转换为YAML string,转换失败抛出异常
     std::string toString() override {
         try {
-            std::shared_lock<std::shared_mutex> lock(m_mutex);
-            return ToStr()(m_val);
+            return ToStr()(*getSnapshot());
         }
         catch (std::exception& e) {
             spdlog::get("system_logger")
@@ -363,25 +483,76 @@ public:
         return false;
     }
 
-    /// @brief 获取当前参数的值
+    /// @brief 从YAML节点转化为参数的值，转换失败返回false
+    bool fromYaml(const YAML::Node& node) override {
+        try {
+            setValue(FromNode()(node));
+            return true;
+        }
+        catch (std::exception& e) {
+            spdlog::get("system_logger")
+                ->error("Configure var::fromYaml exception : {}\n, convert "
+                        "yaml node to {} name {}",
+                        e.what(), typeid(T).name(), m_name);
+        }
+        return false;
+    }
+
+    /// @brief 获取当前参数的值(拷贝)
     T getValue() {
-        std::shared_lock<std::shared_mutex> lock(m_mutex);
-        return m_val;
+        return *getSnapshot();
+    }
+
+    /// @brief 获取当前参数值的快照，快照不会再被修改，持有期间一直有效
+    std::shared_ptr<const T> getSnapshot() const {
+        return m_snapshot.load();
+    }
+
+    /// @brief 当前快照的版本号，每次setValue改变值后变化
+    uint64_t getVersion() const {
+        return m_version.load(std::memory_order_acquire);
+    }
+
+    /// @brief 通过线程本地缓存获取当前参数的值
+    /// 版本号没变时直接返回缓存的快照，只有一次原子load。
+    /// 每个参数每个线程缓存一个快照，返回的引用在本线程下一次调用
+    /// 这个参数的getLocal()之前有效，读其他参数不影响；需要长期持有时用getSnapshot()
+    const T& getLocal() const {
+        //同类型的参数按m_slot在本线程的缓存数组中各占一项，缓存单独分配，数组扩容时引用不失效
+        static thread_local std::vector<std::unique_ptr<LocalCache>> caches;
+        if (m_slot >= caches.size()) {
+            caches.resize(m_slot + 1);
+        }
+        std::unique_ptr<LocalCache>& cache = caches[m_slot];
+        if (!cache) {
+            cache = std::make_unique<LocalCache>();
+        }
+        const uint64_t version = getVersion();
+        if (cache->version != version) {
+            //先读版本号再读快照，快照只会比版本号新，下次调用再核对
+            cache->value = getSnapshot();
+            cache->version = version;
+        }
+        return *cache->value;
     }
 
     /// @brief 设置当前参数的值，如果值发生变化，通知对应的回调函数
+    /// 回调函数在新值发布之前调用，回调中读到的还是旧值
     void setValue(const T& v) {
+        std::shared_ptr<const T> value = std::make_shared<const T>(v);
         {
             std::shared_lock<std::shared_mutex> lock(m_mutex);
-            if (v == m_val) {
+            std::shared_ptr<const T>            old = getSnapshot();
+            if (v == *old) {
                 return;
             }
             for (auto& i : m_cbs) {
-                i.second(m_val, v);
+                i.second(*old, v);
             }
         }
         std::unique_lock<std::shared_mutex> lock(m_mutex);
-        m_val = v;
+        m_snapshot.store(std::move(value));
+        m_version.store(NextVersion(), std::memory_order_release);
     }
 
     /// @brief  返回参数类型名称
@@ -407,18 +578,60 @@ public:
     }
 
 private:
-    std::shared_mutex m_mutex;
-    T                 m_val;
+    /// @brief getLocal()的线程本地缓存
+    struct LocalCache {
+        uint64_t                 version = 0;  //版本号从1开始，0表示没有缓存
+        std::shared_ptr<const T> value;
+    };
+
+    /// @brief 同类型的参数依次编号，作为getLocal()缓存数组的下标
+    static size_t NextSlot() {
+        static std::atomic<size_t> s_slot{0};
+        return s_slot.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    //保护回调函数组
+    std::shared_mutex     m_mutex;
+    SnapshotCell<T>       m_snapshot;  //当前值
+    std::atomic<uint64_t> m_version;   //m_snapshot的版本号
+    const size_t          m_slot;      //getLocal()的缓存下标
     //变更回调函数组, uint64_t key,要求唯一，一般可以用hash
     std::map<uint64_t, on_change_cb> m_cbs;
 };
 
+/// @brief 配置参数的句柄，只包含一个指针，可以随意拷贝和缓存
+/// 配置参数注册后不会删除，句柄一直有效
+template <class T>
+class ConfigHandle {
+private:
+    ConfigVar<T>* m_var = nullptr;
+
+public:
+    ConfigHandle() = default;
+    explicit ConfigHandle(ConfigVar<T>* var) : m_var(var) {}
+
+    ConfigVar<T>* get() const noexcept {
+        return m_var;
+    }
+
+    ConfigVar<T>* operator->() const noexcept {
+        return m_var;
+    }
+
+    ConfigVar<T>& operator*() const noexcept {
+        return *m_var;
+    }
+
+    explicit operator bool() const noexcept {
+        return m_var != nullptr;
+    }
+};
+
 /// @brief ConfigVar的管理类，提供便捷的方法管理ConfigVar
+/// 配置参数保存在ConfigRegistry中，查找已有的参数不加锁也不打日志，
+/// 频繁访问的参数用LookupHandle取得句柄后缓存起来
 class Config {
 public:
-    using ConfigVarMap =
-        std::map<std::string, std::shared_ptr<ConfigVarBase>>;
-
     /// @brief
     /// 获取/创建对应参数名的配置参数，如果名称为name的参数存在，直接返回;如果不存在，直接创建然后用default_value赋值
     /// @param name 参数名称
@@ -430,37 +643,12 @@ public:
     static typename std::shared_ptr<ConfigVar<T>>
     Lookup(const std::string& name, const T& default_value,
            const std::string& description = "") {
-        std::unique_lock<std::shared_mutex> lock(GetMutex());
-
-        auto it = GetDatas().find(name);
-        if (it != GetDatas().end()) {
-            auto tmp = std::dynamic_pointer_cast<ConfigVar<T>>(it->second);
-            if (tmp) {
-                spdlog::get("system_logger")
-                    ->info("Lookup name = {} exists.", name);
-                return tmp;
-            } else {
-                spdlog::get("system_logger")
-                    ->error("Lookup name = {} exists but type not {} "
-                            "realtype = {}, real is {}",
-                            name, typeid(T).name(),
-                            it->second->getTypeName(),
-                            it->second->toString());
-                return nullptr;
-            }
-        }
-
-        if (name.find_first_not_of(
-                "abcdefghikjlmnopqrstuvwxyz._0123456789") !=
-            std::string::npos) {
-            spdlog::error("Lookup name:{} is not valid.", name);
-            throw std::invalid_argument(name);
+        const ConfigRegistry::Entry* entry =
+            Declare(ConfigKey(name), default_value, description);
+        if (!CheckType<T>(entry)) {
+            return nullptr;
         }
-
-        typename std::shared_ptr<ConfigVar<T>> v(
-            new ConfigVar<T>(name, default_value, description));
-        GetDatas()[name] = v;
-        return v;
+        return std::static_pointer_cast<ConfigVar<T>>(entry->var);
     }
 
     /// @brief 查找name对应的配置参数，没有找到则返回nullptr
@@ -469,24 +657,29 @@ public:
     template <class T>
     static typename std::shared_ptr<ConfigVar<T>>
     Lookup(const std::string& name) {
-        std::shared_lock<std::shared_mutex> lock(GetMutex());
-
-        auto it = GetDatas().find(name);
-        if (it == GetDatas().end()) {
+        const ConfigRegistry::Entry* entry =
+            GetRegistry().find(ConfigKey(name));
+        if (!entry || !CheckType<T>(entry)) {
             return nullptr;
         }
-        auto tmp = std::dynamic_pointer_cast<ConfigVar<T>>(it->second);
-        if (tmp) {
-            spdlog::get("system_logger")
-                ->info("Lookup name = {} exists.", name);
-            return tmp;
-        }
-        spdlog::get("system_logger")
-            ->error("Lookup name = {} exists but type not {} "
-                    "realtype = {}, real is {}",
-                    name, typeid(T).name(), it->second->getTypeName(),
-                    it->second->toString());
-        return nullptr;
+        return std::static_pointer_cast<ConfigVar<T>>(entry->var);
+    }
+
+    /// @brief 同Lookup(name, default_value,
+    /// description)，返回句柄，名称可以是编译期算好哈希值的ConfigKey
+    template <class T>
+    static ConfigHandle<T> LookupHandle(const ConfigKey&   key,
+                                        const T&           default_value,
+                                        const std::string& description = "") {
+        return ConfigHandle<T>(
+            CheckType<T>(Declare(key, default_value, description)));
+    }
+
+    /// @brief 同Lookup(name)，返回句柄，没有找到或者类型不匹配时句柄为空
+    template <class T>
+    static ConfigHandle<T> LookupHandle(const ConfigKey& key) {
+        const ConfigRegistry::Entry* entry = GetRegistry().find(key);
+        return ConfigHandle<T>(entry ? CheckType<T>(entry) : nullptr);
     }
 
     /// @brief 从YAML::Node初始化配置模块
@@ -502,22 +695,53 @@ public:
     static std::shared_ptr<ConfigVarBase>
     LookupBase(const std::string& name);
 
-    /// @brief 遍历模块中所有配置项
+    /// @brief 按注册顺序遍历模块中所有配置项
     /// @param cb 配置项回调函数
     static void
     Visit(std::function<void(std::shared_ptr<ConfigVarBase>)> cb);
 
 private:
     /// @brief 返回所有配置项(单例模式)
-    static ConfigVarMap& GetDatas() {
-        static ConfigVarMap s_datas;
-        return s_datas;
+    static ConfigRegistry& GetRegistry() {
+        static ConfigRegistry s_registry;
+        return s_registry;
     }
 
-    /// @brief 返回配置项的rwMutex
-    static std::shared_mutex& GetMutex() {
-        static std::shared_mutex s_mutex;
-        return s_mutex;
+    /// @brief 返回名称对应的条目，不存在时用default_value创建
+    template <class T>
+    static const ConfigRegistry::Entry* Declare(const ConfigKey&   key,
+                                                const T&           default_value,
+                                                const std::string& description) {
+        if (const ConfigRegistry::Entry* entry = GetRegistry().find(key)) {
+            return entry;
+        }
+        if (key.name.find_first_not_of(
+                "abcdefghikjlmnopqrstuvwxyz._0123456789") !=
+            std::string_view::npos) {
+            spdlog::error("Lookup name:{} is not valid.", key.name);
+            throw std::invalid_argument(std::string(key.name));
+        }
+        //其他线程同时注册了同一个名称时，insert返回先注册的条目
+        return GetRegistry().insert(
+            key,
+            std::make_shared<ConfigVar<T>>(std::string(key.name), default_value,
+                                           description),
+            typeid(ConfigVar<T>));
+    }
+
+    /// @brief 条目的类型是ConfigVar<T>时返回它，否则打印错误并返回nullptr
+    /// 比较插入时记录的类型，不做dynamic_cast
+    template <class T>
+    static ConfigVar<T>* CheckType(const ConfigRegistry::Entry* entry) {
+        if (*entry->type == typeid(ConfigVar<T>)) {
+            return static_cast<ConfigVar<T>*>(entry->var.get());
+        }
+        spdlog::get("system_logger")
+            ->error("Lookup name = {} exists but type not {} "
+                    "realtype = {}, real is {}",
+                    entry->name, typeid(T).name(), entry->var->getTypeName(),
+                    entry->var->toString());
+        return nullptr;
     }
 };
 
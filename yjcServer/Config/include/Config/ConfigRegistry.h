@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <vector>
+
+/*
+ * 配置参数的注册表
+ * 开放寻址(线性探测)的哈希表，槽位里是指向条目的原子指针，条目里保存名称和预先算好的哈希值。
+ * 查找不加锁: 按哈希值定位后逐个比较槽位，先比哈希值再比名称，遇到空槽位说明不存在。
+ * 插入由互斥锁串行，条目构造完成后才发布到槽位；配置参数注册后不会删除。
+ * 条目记录参数的具体类型，按类型取用时比较类型即可，不需要dynamic_cast。
+ * 装载率超过一半时换成两倍大的表，旧表可能还有读者在探测，保留到注册表析构。
+ * 各级表的大小依次翻倍，保留的旧表加起来不超过当前表。
+ */
+
+namespace yjcServer {
+
+class ConfigVarBase;
+
+/// @brief 配置参数名和它的哈希值，用字符串常量构造时哈希值在编译期算好
+struct ConfigKey {
+    std::string_view name;
+    uint64_t         hash;
+
+    constexpr ConfigKey(std::string_view n) : name(n), hash(Hash(n)) {}
+    constexpr ConfigKey(const char* n) : ConfigKey(std::string_view(n)) {}
+    ConfigKey(const std::string& n) : ConfigKey(std::string_view(n)) {}
+
+    /// @brief FNV-1a，最后把高位混到低位，表的下标取低位
+    static constexpr uint64_t Hash(std::string_view s) noexcept {
+        uint64_t h = 14695981039346656037ull;
+        for (char c : s) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ull;
+        }
+        return h ^ (h >> 32);
+    }
+};
+
+class ConfigRegistry {
+public:
+    /// @brief 注册表的条目，发布后不再修改
+    struct Entry {
+        uint64_t                       hash;
+        std::string                    name;
+        std::shared_ptr<ConfigVarBase> var;
+        const std::type_info*          type;  //var的具体类型
+    };
+
+private:
+    struct Table {
+        size_t                                       mask;  //槽位数-1，槽位数是2的幂
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+
+        explicit Table(size_t capacity)
+            : mask(capacity - 1),
+              slots(std::make_unique<std::atomic<const Entry*>[]>(capacity)) {
+        }
+    };
+
+    std::atomic<const Table*>           m_table;
+    std::mutex                          m_mutex;    //串行插入
+    std::vector<std::unique_ptr<Entry>> m_entries;  //按注册顺序，持有所有条目
+    std::vector<std::unique_ptr<Table>> m_tables;   //当前表和所有旧表
+
+    /// @brief 在table中放入entry，调用者保证有空槽位
+    static void place(const Table& table, const Entry* entry) noexcept;
+
+public:
+    /// @param capacity 初始槽位数，向上取整到2的幂
+    explicit ConfigRegistry(size_t capacity = 64);
+
+    ConfigRegistry(const ConfigRegistry&) = delete;
+    ConfigRegistry& operator=(const ConfigRegistry&) = delete;
+
+    /// @brief 查找条目，不加锁，没有找到返回nullptr
+    const Entry* find(const ConfigKey& key) const noexcept {
+        const Table* table = m_table.load(std::memory_order_acquire);
+        for (size_t i = key.hash & table->mask;; i = (i + 1) & table->mask) {
+            const Entry* entry =
+                table->slots[i].load(std::memory_order_acquire);
+            if (entry == nullptr) {
+                return nullptr;
+            }
+            if (entry->hash == key.hash && entry->name == key.name) {
+                return entry;
+            }
+        }
+    }
+
+    /// @brief 插入var，名称已经存在时不插入，返回已有的条目
+    /// @param type var的具体类型
+    const Entry* insert(const ConfigKey&                      key,
+                        const std::shared_ptr<ConfigVarBase>& var,
+                        const std::type_info&                 type);
+
+    /// @brief 按注册顺序遍历所有配置参数，回调在锁外执行
+    void visit(
+        const std::function<void(const std::shared_ptr<ConfigVarBase>&)>& cb);
+
+    size_t size();
+};
+
+}  // namespace yjcServer
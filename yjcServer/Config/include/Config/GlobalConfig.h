@@ -0,0 +1,138 @@
+#pragma once
+#include <Config/Config.h>
+#include <string>
+#include <vector>
+
+namespace yjcServer {
+
+/// @brief 定义全局的配置结构
+struct GlobalConfig {
+    bool                async = false;
+    size_t              thread_pool_size = 0;
+    std::string         thread_pool_mode = "shared";  //shared/work_stealing/mpmc
+    size_t              thread_pool_queue_capacity = 4096;  //mpmc模式的环形队列容量
+    std::string         thread_pool_affinity = "none";  //none/compact/scatter/numa
+    std::string         thread_pool_cpus = "";  //可用的CPU列表，如"0-7,16"，空表示全部
+    bool                exclude_isolated_cpus = true;  //不使用isolcpus隔离的CPU
+    std::vector<size_t> thread_pool_lane_weights = {8, 4, 1};  //各优先级通道的权重
+    size_t thread_pool_min_size = 0;  //弹性伸缩的下限，0表示和初始线程数相同
+    size_t thread_pool_max_size = 0;  //弹性伸缩的上限，不大于初始线程数时不扩容
+    size_t thread_pool_target_wait_us = 2000;  //任务排队时间超过它时增加线程
+    size_t thread_pool_idle_timeout_ms = 30000;  //多于下限的线程空闲这么久后退出
+    bool   thread_pool_warmup = false;  //工作线程启动时预热栈、线程局部对象和缓存
+    bool   thread_pool_metrics = true;  //记录每个工作线程的统计和任务的排队/执行时间
+
+    bool operator==(const GlobalConfig& other) const {
+        return async == other.async &&
+               thread_pool_size == other.thread_pool_size &&
+               thread_pool_mode == other.thread_pool_mode &&
+               thread_pool_queue_capacity == other.thread_pool_queue_capacity &&
+               thread_pool_affinity == other.thread_pool_affinity &&
+               thread_pool_cpus == other.thread_pool_cpus &&
+               exclude_isolated_cpus == other.exclude_isolated_cpus &&
+               thread_pool_lane_weights == other.thread_pool_lane_weights &&
+               thread_pool_min_size == other.thread_pool_min_size &&
+               thread_pool_max_size == other.thread_pool_max_size &&
+               thread_pool_target_wait_us == other.thread_pool_target_wait_us &&
+               thread_pool_idle_timeout_ms == other.thread_pool_idle_timeout_ms &&
+               thread_pool_warmup == other.thread_pool_warmup &&
+               thread_pool_metrics == other.thread_pool_metrics;
+    }
+};
+
+/// @brief fromYaml(GlobalConfig)
+template <>
+class LexicalCast<YAML::Node, GlobalConfig> {
+public:
+    GlobalConfig operator()(const YAML::Node& node) {
+        GlobalConfig res;
+        if (node["async"].IsDefined()) {
+            res.async = node["async"].as<bool>();
+        }
+        if (node["thread_pool_size"].IsDefined()) {
+            res.thread_pool_size = node["thread_pool_size"].as<size_t>();
+        }
+        if (node["thread_pool_mode"].IsDefined()) {
+            res.thread_pool_mode = node["thread_pool_mode"].as<std::string>();
+        }
+        if (node["thread_pool_queue_capacity"].IsDefined()) {
+            res.thread_pool_queue_capacity =
+                node["thread_pool_queue_capacity"].as<size_t>();
+        }
+        if (node["thread_pool_affinity"].IsDefined()) {
+            res.thread_pool_affinity =
+                node["thread_pool_affinity"].as<std::string>();
+        }
+        if (node["thread_pool_cpus"].IsDefined()) {
+            res.thread_pool_cpus = node["thread_pool_cpus"].as<std::string>();
+        }
+        if (node["exclude_isolated_cpus"].IsDefined()) {
+            res.exclude_isolated_cpus = node["exclude_isolated_cpus"].as<bool>();
+        }
+        if (node["thread_pool_lane_weights"].IsDefined()) {
+            res.thread_pool_lane_weights =
+                node["thread_pool_lane_weights"].as<std::vector<size_t>>();
+        }
+        if (node["thread_pool_min_size"].IsDefined()) {
+            res.thread_pool_min_size = node["thread_pool_min_size"].as<size_t>();
+        }
+        if (node["thread_pool_max_size"].IsDefined()) {
+            res.thread_pool_max_size = node["thread_pool_max_size"].as<size_t>();
+        }
+        if (node["thread_pool_target_wait_us"].IsDefined()) {
+            res.thread_pool_target_wait_us =
+                node["thread_pool_target_wait_us"].as<size_t>();
+        }
+        if (node["thread_pool_idle_timeout_ms"].IsDefined()) {
+            res.thread_pool_idle_timeout_ms =
+                node["thread_pool_idle_timeout_ms"].as<size_t>();
+        }
+        if (node["thread_pool_warmup"].IsDefined()) {
+            res.thread_pool_warmup = node["thread_pool_warmup"].as<bool>();
+        }
+        if (node["thread_pool_metrics"].IsDefined()) {
+            res.thread_pool_metrics = node["thread_pool_metrics"].as<bool>();
+        }
+        return res;
+    }
+};
+
+/// @brief fromStirng(GlobalConfig)
+template <>
+class LexicalCast<std::string, GlobalConfig> {
+public:
+    GlobalConfig operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, GlobalConfig>()(YAML::Load(v));
+    }
+};
+
+/// @brief toString(GlobalConfig)
+template <>
+class LexicalCast<GlobalConfig, std::string> {
+public:
+    std::string operator()(const GlobalConfig& v) {
+        YAML::Node node;
+        node["async"] = v.async;
+        node["thread_pool_size"] = v.thread_pool_size;
+        node["thread_pool_mode"] = v.thread_pool_mode;
+        node["thread_pool_queue_capacity"] = v.thread_pool_queue_capacity;
+        node["thread_pool_affinity"] = v.thread_pool_affinity;
+        node["thread_pool_cpus"] = v.thread_pool_cpus;
+        node["exclude_isolated_cpus"] = v.exclude_isolated_cpus;
+        node["thread_pool_lane_weights"] = v.thread_pool_lane_weights;
+        node["thread_pool_min_size"] = v.thread_pool_min_size;
+        node["thread_pool_max_size"] = v.thread_pool_max_size;
+        node["thread_pool_target_wait_us"] = v.thread_pool_target_wait_us;
+        node["thread_pool_idle_timeout_ms"] = v.thread_pool_idle_timeout_ms;
+        node["thread_pool_warmup"] = v.thread_pool_warmup;
+        node["thread_pool_metrics"] = v.thread_pool_metrics;
+        std::stringstream ss;
+        ss << node;
+        return ss.str();
+    }
+};
+
+/// @brief 全局配置项"global"的句柄，第一次调用时注册
+ConfigHandle<GlobalConfig> GetGlobalConfig();
+
+}  // namespace yjcServer
@@ -1,5 +1,6 @@
 #pragma once
 #include <Config/Config.h>
+#include <Config/GlobalConfig.h>
 #include <Config/LogConfig.h>
 #include <Config/util.h>
 #include <spdlog/spdlog.h>
@@ -8,4 +9,3 @@
 //前置声明
 struct SinkConfig;
 struct LoggerConfig;
-struct GlobalConfig;
\ No newline at end of file
@@ -14,10 +14,8 @@ namespace yjcServer {
  */
 
 ConfigVarBase::ptr Config::LookupBase(const std::string& name) {
-    std::shared_lock<std::shared_mutex> lock(GetMutex());
-
-    auto it = GetDatas().find(name);
-    return it == GetDatas().end() ? nullptr : it->second;
+    const ConfigRegistry::Entry* entry = GetRegistry().find(ConfigKey(name));
+    return entry ? entry->var : nullptr;
 }
 
 /// @brief 遍历一个节点，将节点和所有成员放入一个列表中
@@ -60,13 +58,8 @@ void Config::LoadFromYaml(const YAML::Node& root) {
         if (!var) {
             continue;
         }
-        if (i.second.IsScalar()) {
-            var->fromString(i.second.Scalar());
-        } else {
-            std::stringstream ss;
-            ss << i.second;
-            var->fromString(ss.str());
-        }
+        //直接从节点转换，不再序列化成字符串后重新解析
+        var->fromYaml(i.second);
     }
 }
 
@@ -91,12 +84,7 @@ void Config::LoadFromConfigDir(const std::string& path, bool force) {
 }
 
 void Config::Visit(std::function<void(std::shared_ptr<ConfigVarBase>)> cb) {
-    std::shared_lock<std::shared_mutex> lock(GetMutex());
-
-    ConfigVarMap& m = GetDatas();
-    for (auto it = m.begin(); it != m.end(); ++it) {
-        cb(it->second);
-    }
+    GetRegistry().visit(cb);
 }
 
 }  // namespace yjcServer
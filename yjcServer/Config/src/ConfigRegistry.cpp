@@ -0,0 +1,69 @@
+#include <Config/ConfigRegistry.h>
+#include <algorithm>
+#include <bit>
+
+namespace yjcServer {
+
+ConfigRegistry::ConfigRegistry(size_t capacity) {
+    m_tables.push_back(
+        std::make_unique<Table>(std::bit_ceil(std::max<size_t>(capacity, 2))));
+    m_table.store(m_tables.back().get(), std::memory_order_release);
+}
+
+void ConfigRegistry::place(const Table& table, const Entry* entry) noexcept {
+    size_t i = entry->hash & table.mask;
+    while (table.slots[i].load(std::memory_order_relaxed) != nullptr) {
+        i = (i + 1) & table.mask;
+    }
+    //条目的内容在发布之前写好
+    table.slots[i].store(entry, std::memory_order_release);
+}
+
+const ConfigRegistry::Entry*
+ConfigRegistry::insert(const ConfigKey&                      key,
+                       const std::shared_ptr<ConfigVarBase>& var,
+                       const std::type_info&                 type) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (const Entry* entry = find(key)) {
+        return entry;
+    }
+    m_entries.push_back(std::make_unique<Entry>(
+        Entry{key.hash, std::string(key.name), var, &type}));
+    const Entry* entry = m_entries.back().get();
+
+    const Table* table = m_table.load(std::memory_order_relaxed);
+    //装载率不超过一半，探测总能遇到空槽位
+    if (2 * m_entries.size() > table->mask + 1) {
+        m_tables.push_back(std::make_unique<Table>(2 * (table->mask + 1)));
+        table = m_tables.back().get();
+        for (auto& old : m_entries) {
+            place(*table, old.get());
+        }
+        m_table.store(table, std::memory_order_release);
+    } else {
+        place(*table, entry);
+    }
+    return entry;
+}
+
+void ConfigRegistry::visit(
+    const std::function<void(const std::shared_ptr<ConfigVarBase>&)>& cb) {
+    std::vector<std::shared_ptr<ConfigVarBase>> vars;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        vars.reserve(m_entries.size());
+        for (auto& entry : m_entries) {
+            vars.push_back(entry->var);
+        }
+    }
+    for (auto& var : vars) {
+        cb(var);
+    }
+}
+
+size_t ConfigRegistry::size() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+}  // namespace yjcServer
@@ -1,3 +1,4 @@
+#include <Config/GlobalConfig.h>
 #include <Config/LogConfig.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/daily_file_sink.h>
@@ -103,17 +104,6 @@ struct LoggerConfig {
     }
 };
 
-/// @brief 定义全局的配置结构
-struct GlobalConfig {
-    bool   async;
-    size_t thread_pool_size;
-
-    bool operator==(const GlobalConfig& other) const {
-        return async == other.async &&
-               thread_pool_size == other.thread_pool_size;
-    }
-};
-
 /*
  * -------------------------------------------------------------------------------------
  * -----------------------------解析自定义类型需要的类型转换---------------------------------
@@ -121,12 +111,11 @@ struct GlobalConfig {
  */
 
 /// @brief
-/// fromString(SinkConfig),对于自定义类型，需要实现类型转换以便支持yaml的解析
+/// fromYaml(SinkConfig),对于自定义类型，需要实现类型转换以便支持yaml的解析
 template <>
-class LexicalCast<std::string, SinkConfig> {
+class LexicalCast<YAML::Node, SinkConfig> {
 public:
-    SinkConfig operator()(const std::string& v) {
-        YAML::Node node = YAML::Load(v);
+    SinkConfig operator()(const YAML::Node& node) {
         SinkConfig res;
         if (node["type"].IsDefined()) {
             res.type = node["type"].as<std::string>();
@@ -147,6 +136,15 @@ public:
     }
 };
 
+/// @brief fromString(SinkConfig)
+template <>
+class LexicalCast<std::string, SinkConfig> {
+public:
+    SinkConfig operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, SinkConfig>()(YAML::Load(v));
+    }
+};
+
 /// @brief toString(SinkConfig)
 template <>
 class LexicalCast<SinkConfig, std::string> {
@@ -164,12 +162,11 @@ public:
     }
 };
 
-/// @brief fromstring(LoggerConfig)
+/// @brief fromYaml(LoggerConfig)
 template <>
-class LexicalCast<std::string, LoggerConfig> {
+class LexicalCast<YAML::Node, LoggerConfig> {
 public:
-    LoggerConfig operator()(const std::string& v) {
-        YAML::Node   node = YAML::Load(v);
+    LoggerConfig operator()(const YAML::Node& node) {
         LoggerConfig res;
         if (node["name"].IsDefined()) {
             res.name = node["name"].as<std::string>();
@@ -177,14 +174,23 @@ public:
         if (node["level"].IsDefined()) {
             res.level = node["level"].as<std::string>();
         }
-        std::stringstream ss;
-        ss << node["sinks"];
-        res.sinks =
-            LexicalCast<std::string, std::vector<SinkConfig>>()(ss.str());
+        if (node["sinks"].IsDefined()) {
+            res.sinks = LexicalCast<YAML::Node, std::vector<SinkConfig>>()(
+                node["sinks"]);
+        }
         return res;
     }
 };
 
+/// @brief fromstring(LoggerConfig)
+template <>
+class LexicalCast<std::string, LoggerConfig> {
+public:
+    LoggerConfig operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, LoggerConfig>()(YAML::Load(v));
+    }
+};
+
 /// @brief toString(LoggerConfig)
 template <>
 class LexicalCast<LoggerConfig, std::string> {
@@ -201,37 +207,6 @@ public:
     }
 };
 
-/// @brief fromStirng(GlobalConfig)
-template <>
-class LexicalCast<std::string, GlobalConfig> {
-public:
-    GlobalConfig operator()(const std::string& v) {
-        YAML::Node   node = YAML::Load(v);
-        GlobalConfig res;
-        if (node["async"].IsDefined()) {
-            res.async = node["async"].as<bool>();
-        }
-        if (node["thread_pool_size"].IsDefined()) {
-            res.thread_pool_size = node["thread_pool_size"].as<size_t>();
-        }
-        return res;
-    }
-};
-
-/// @brief toString(GlobalConfig)
-template <>
-class LexicalCast<GlobalConfig, std::string> {
-public:
-    std::string operator()(const GlobalConfig& v) {
-        YAML::Node node;
-        node["async"] = v.async;
-        node["thread_pool_size"] = v.thread_pool_size;
-        std::stringstream ss;
-        ss << node;
-        return ss.str();
-    }
-};
-
 /*
  * ------------------------------------------------------------------------------
  * ------------------------------------------------------------------------------
@@ -243,13 +218,19 @@ public:
  */
 static auto logger_configs =
     Config::Lookup<std::vector<LoggerConfig>>("loggers", {}, "logger_configs");
-static auto global_configs =
-    Config::Lookup<GlobalConfig>("global", {}, "global_configs");
+static auto global_configs = GetGlobalConfig();
 
 /*
  *----------------------------------------------------------------------------
  */
 
+ConfigHandle<GlobalConfig> GetGlobalConfig() {
+    //函数内静态变量，其他编译单元的静态初始化也能安全使用
+    static const ConfigHandle<GlobalConfig> configs =
+        Config::LookupHandle<GlobalConfig>("global", {}, "global_configs");
+    return configs;
+}
+
 void LogConfigInitializer::init() {
     //删除所有旧日志
     fs::path logpath("/home/yjc/yjcServer/logs");
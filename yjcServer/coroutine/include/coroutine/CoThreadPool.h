@@ -11,7 +11,8 @@ private:
 public:
     CoThreadPool();
 
-    class schedule_awaiter {
+    /// @brief awaiter本身就是调度队列的节点，切换到线程池没有任何分配
+    class schedule_awaiter : public schedule_node {
     private:
         ThreadPool& m_pool;
 
@@ -20,7 +21,7 @@ public:
 
         bool await_ready();  // false
         void await_resume() {}
-        //暂停，执行后跳转到调用者
+        //暂停，由线程池的工作线程恢复
         void await_suspend(std::coroutine_handle<> handle);
 
     };  // class schedule_awaiter
@@ -0,0 +1,270 @@
+#pragma once
+#include <thread/Thread.h>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+/*
+ * 有界多生产者多消费者协程通道
+ *   async_channel<conn_ptr> pool(16);
+ *   co_await pool.send(conn);              //满时挂起，通道关闭返回false
+ *   std::optional<conn_ptr> c = co_await pool.recv();  //空时挂起，关闭且取空后返回空
+ * capacity为0时是无缓冲的会合通道，send要等到有人recv才完成。
+ * 有等待的接收者时send直接把值交给它，不经过缓冲区；缓冲区满后发送者
+ * 按FIFO排队，接收者取走一个值后把最早的发送者的值补进缓冲区并恢复它。
+ * 状态由Spinlock保护，只在几条指针/移动操作期间持有，恢复协程前释放。
+ * 被唤醒的一方在唤醒它的线程上恢复。
+ */
+
+namespace yjcServer {
+
+template <class T>
+class async_channel {
+public:
+    class send_awaiter;
+    class recv_awaiter;
+
+private:
+    /// @brief 侵入式FIFO等待队列
+    template <class Node>
+    struct waiter_list {
+        Node* head = nullptr;
+        Node* tail = nullptr;
+
+        bool empty() const noexcept {
+            return head == nullptr;
+        }
+        void push(Node* node) noexcept {
+            node->m_next = nullptr;
+            if (tail) {
+                tail->m_next = node;
+            } else {
+                head = node;
+            }
+            tail = node;
+        }
+        Node* pop() noexcept {
+            Node* node = head;
+            head = node->m_next;
+            if (head == nullptr) {
+                tail = nullptr;
+            }
+            return node;
+        }
+    };
+
+    std::vector<std::optional<T>> m_buffer;  //环形缓冲区
+    size_t                        m_head = 0;
+    size_t                        m_size = 0;
+    bool                          m_closed = false;
+    Spinlock                      m_lock;
+    waiter_list<send_awaiter>     m_senders;
+    waiter_list<recv_awaiter>     m_receivers;
+
+    void push_buffer(T&& value) {
+        m_buffer[(m_head + m_size) % m_buffer.size()].emplace(std::move(value));
+        ++m_size;
+    }
+
+    T pop_buffer() {
+        T value = std::move(*m_buffer[m_head]);
+        m_buffer[m_head].reset();
+        m_head = (m_head + 1) % m_buffer.size();
+        --m_size;
+        return value;
+    }
+
+public:
+    class send_awaiter {
+        friend class async_channel;
+        friend struct waiter_list<send_awaiter>;
+
+    private:
+        async_channel&          m_channel;
+        T                       m_value;
+        bool                    m_ok = true;
+        send_awaiter*           m_next = nullptr;
+        std::coroutine_handle<> m_handle;
+
+    public:
+        send_awaiter(async_channel& channel, T value)
+            : m_channel(channel), m_value(std::move(value)) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            recv_awaiter* receiver = nullptr;
+            {
+                std::lock_guard<Spinlock> lock(m_channel.m_lock);
+                if (m_channel.m_closed) {
+                    m_ok = false;
+                    return false;
+                }
+                if (!m_channel.m_receivers.empty()) {
+                    receiver = m_channel.m_receivers.pop();
+                    receiver->m_value.emplace(std::move(m_value));
+                } else if (m_channel.m_size < m_channel.m_buffer.size()) {
+                    m_channel.push_buffer(std::move(m_value));
+                    return false;
+                } else {
+                    m_handle = handle;
+                    m_channel.m_senders.push(this);
+                    return true;
+                }
+            }
+            receiver->m_handle.resume();
+            return false;
+        }
+
+        /// @return 通道已关闭时返回false，值没有被发送
+        bool await_resume() const noexcept {
+            return m_ok;
+        }
+    };
+
+    class recv_awaiter {
+        friend class async_channel;
+        friend struct waiter_list<recv_awaiter>;
+
+    private:
+        async_channel&          m_channel;
+        std::optional<T>        m_value;
+        recv_awaiter*           m_next = nullptr;
+        std::coroutine_handle<> m_handle;
+
+    public:
+        explicit recv_awaiter(async_channel& channel) : m_channel(channel) {}
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        bool await_suspend(std::coroutine_handle<> handle) {
+            send_awaiter* sender = nullptr;
+            {
+                std::lock_guard<Spinlock> lock(m_channel.m_lock);
+                if (m_channel.m_size > 0) {
+                    m_value.emplace(m_channel.pop_buffer());
+                    //缓冲区空出一个位置，补入最早的发送者的值
+                    if (!m_channel.m_senders.empty()) {
+                        sender = m_channel.m_senders.pop();
+                        m_channel.push_buffer(std::move(sender->m_value));
+                    }
+                } else if (!m_channel.m_senders.empty()) {
+                    //无缓冲通道，直接从发送者取
+                    sender = m_channel.m_senders.pop();
+                    m_value.emplace(std::move(sender->m_value));
+                } else if (m_channel.m_closed) {
+                    return false;
+                } else {
+                    m_handle = handle;
+                    m_channel.m_receivers.push(this);
+                    return true;
+                }
+            }
+            if (sender) {
+                sender->m_handle.resume();
+            }
+            return false;
+        }
+
+        /// @return 通道关闭且已取空时返回空
+        std::optional<T> await_resume() {
+            return std::move(m_value);
+        }
+    };
+
+    explicit async_channel(size_t capacity) : m_buffer(capacity) {}
+    async_channel(const async_channel&) = delete;
+    async_channel& operator=(const async_channel&) = delete;
+
+    /// @brief co_await send(v)，缓冲区满时挂起
+    send_awaiter send(T value) {
+        return send_awaiter{*this, std::move(value)};
+    }
+
+    /// @brief co_await recv()，没有值时挂起
+    recv_awaiter recv() {
+        return recv_awaiter{*this};
+    }
+
+    /// @brief 不挂起的发送，缓冲区满或已关闭时返回false
+    bool try_send(T& value) {
+        recv_awaiter* receiver = nullptr;
+        {
+            std::lock_guard<Spinlock> lock(m_lock);
+            if (m_closed) {
+                return false;
+            }
+            if (!m_receivers.empty()) {
+                receiver = m_receivers.pop();
+                receiver->m_value.emplace(std::move(value));
+            } else if (m_size < m_buffer.size()) {
+                push_buffer(std::move(value));
+                return true;
+            } else {
+                return false;
+            }
+        }
+        receiver->m_handle.resume();
+        return true;
+    }
+
+    /// @brief 不挂起的接收，没有值时返回空
+    std::optional<T> try_recv() {
+        std::optional<T> value;
+        send_awaiter*    sender = nullptr;
+        {
+            std::lock_guard<Spinlock> lock(m_lock);
+            if (m_size > 0) {
+                value.emplace(pop_buffer());
+                if (!m_senders.empty()) {
+                    sender = m_senders.pop();
+                    push_buffer(std::move(sender->m_value));
+                }
+            } else if (!m_senders.empty()) {
+                sender = m_senders.pop();
+                value.emplace(std::move(sender->m_value));
+            }
+        }
+        if (sender) {
+            sender->m_handle.resume();
+        }
+        return value;
+    }
+
+    /// @brief 关闭通道: 挂起的发送者返回false，接收者取空缓冲区后返回空
+    void close() {
+        waiter_list<send_awaiter> senders;
+        waiter_list<recv_awaiter> receivers;
+        {
+            std::lock_guard<Spinlock> lock(m_lock);
+            if (m_closed) {
+                return;
+            }
+            m_closed = true;
+            std::swap(senders, m_senders);
+            std::swap(receivers, m_receivers);
+        }
+        while (!senders.empty()) {
+            send_awaiter* sender = senders.pop();
+            sender->m_ok = false;
+            sender->m_handle.resume();
+        }
+        while (!receivers.empty()) {
+            receivers.pop()->m_handle.resume();
+        }
+    }
+
+    bool is_closed() {
+        std::lock_guard<Spinlock> lock(m_lock);
+        return m_closed;
+    }
+};
+
+}  // namespace yjcServer
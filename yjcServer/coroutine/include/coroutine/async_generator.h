@@ -0,0 +1,243 @@
+#pragma once
+#include <coroutine/frame_allocator.h>
+#include <coroutine/task.h>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/*
+ * 异步生成器，协程中可以同时使用co_yield和co_await
+ *   async_generator<int> lines(file_descriptor& fd) {
+ *       while (...) { co_await ...; co_yield value; }
+ *   }
+ * 消费者逐个取值，不需要一次缓冲全部结果:
+ *   while (int* v = co_await gen.next()) { ... }
+ *   for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it) {...}
+ *   co_await for_each(std::move(gen), [](int& v) { ... });
+ * 生产者与消费者之间用对称转移切换；生产者惰性启动，第一次取值时才执行。
+ * co_yield的值在消费者下一次取值前保持有效(临时对象也一样)。
+ */
+
+namespace yjcServer {
+
+template <class T>
+class async_generator;
+
+template <class T>
+class async_generator_promise {
+public:
+    using value_type = std::remove_reference_t<T>;
+
+private:
+    value_type*             m_value = nullptr;
+    std::exception_ptr      m_exception;
+    std::coroutine_handle<> m_consumer{std::noop_coroutine()};
+
+    /// @brief co_yield/结束时跳转回消费者
+    struct yield_awaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<async_generator_promise> current) noexcept {
+            return current.promise().m_consumer;
+        }
+        void await_resume() const noexcept {}
+    };
+
+public:
+    //协程帧与task共用分配器
+    static void* operator new(std::size_t size) {
+        return frame_allocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t) noexcept {
+        frame_allocator::deallocate(ptr);
+    }
+
+    async_generator<T> get_return_object() noexcept;
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    yield_awaiter final_suspend() noexcept {
+        m_value = nullptr;
+        return {};
+    }
+
+    yield_awaiter yield_value(value_type& value) noexcept {
+        m_value = std::addressof(value);
+        return {};
+    }
+
+    yield_awaiter yield_value(value_type&& value) noexcept {
+        m_value = std::addressof(value);
+        return {};
+    }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept {
+        m_exception = std::current_exception();
+    }
+
+    void set_consumer(std::coroutine_handle<> consumer) noexcept {
+        m_consumer = consumer;
+    }
+
+    /// @brief 当前值，已结束返回nullptr；生产者抛出的异常在这里重新抛出
+    value_type* value() const {
+        if (m_exception) [[unlikely]] {
+            std::rethrow_exception(m_exception);
+        }
+        return m_value;
+    }
+};
+
+template <class T>
+class [[YJC_CO_AWAIT_HINT]] async_generator {
+public:
+    using promise_type = async_generator_promise<T>;
+    using value_type = typename promise_type::value_type;
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    /// @brief 恢复生产者直到下一个co_yield或结束
+    struct advance_awaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept {
+            return !handle || handle.done();
+        }
+        std::coroutine_handle<>
+        await_suspend(std::coroutine_handle<> consumer) noexcept {
+            handle.promise().set_consumer(consumer);
+            return handle;
+        }
+        value_type* await_resume() const {
+            return handle ? handle.promise().value() : nullptr;
+        }
+    };
+
+public:
+    class iterator {
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = async_generator::value_type;
+        using reference = value_type&;
+        using pointer = value_type*;
+
+        iterator() noexcept = default;
+        explicit iterator(std::coroutine_handle<promise_type> handle) noexcept
+            : m_handle(handle) {}
+
+        reference operator*() const {
+            return *m_handle.promise().value();
+        }
+        pointer operator->() const {
+            return m_handle.promise().value();
+        }
+
+        bool operator==(std::default_sentinel_t) const noexcept {
+            return !m_handle || m_handle.done();
+        }
+
+        /// @brief co_await ++it
+        auto operator++() {
+            struct awaiter : advance_awaiter {
+                iterator& it;
+
+                iterator& await_resume() const {
+                    advance_awaiter::await_resume();
+                    return it;
+                }
+            };
+            return awaiter{{m_handle}, *this};
+        }
+    };
+
+    async_generator() = default;
+    explicit async_generator(
+        std::coroutine_handle<promise_type> handle) noexcept
+        : m_handle(handle) {}
+
+    async_generator(async_generator&& other) noexcept
+        : m_handle(std::exchange(other.m_handle, nullptr)) {}
+
+    async_generator& operator=(async_generator&& other) noexcept {
+        if (this != std::addressof(other)) [[likely]] {
+            if (m_handle) {
+                m_handle.destroy();
+            }
+            m_handle = std::exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    async_generator(const async_generator&) = delete;
+    async_generator& operator=(const async_generator&) = delete;
+
+    //生产者挂起在co_yield或co_await上时销毁，帧内的局部对象正常析构
+    ~async_generator() {
+        if (m_handle) {
+            m_handle.destroy();
+        }
+    }
+
+    /// @brief co_await next()取下一个值的指针，结束时返回nullptr
+    advance_awaiter next() noexcept {
+        return advance_awaiter{m_handle};
+    }
+
+    /// @brief co_await begin()启动生产者并返回指向第一个值的迭代器
+    auto begin() {
+        struct awaiter : advance_awaiter {
+            iterator await_resume() const {
+                advance_awaiter::await_resume();
+                return iterator{this->handle};
+            }
+        };
+        return awaiter{{m_handle}};
+    }
+
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]] bool is_done() const noexcept {
+        return !m_handle || m_handle.done();
+    }
+};
+
+template <class T>
+inline async_generator<T>
+async_generator_promise<T>::get_return_object() noexcept {
+    return async_generator<T>{
+        std::coroutine_handle<async_generator_promise>::from_promise(*this)};
+}
+
+/// @brief 依次对每个值调用f，f返回task时等待它结束再取下一个
+template <class T, class F>
+requires std::invocable<F&, std::remove_reference_t<T>&>
+task<> for_each(async_generator<T> gen, F f) {
+    while (auto* value = co_await gen.next()) {
+        using result = std::invoke_result_t<F&, std::remove_reference_t<T>&>;
+        if constexpr (std::is_void_v<result>) {
+            f(*value);
+        } else {
+            co_await f(*value);
+        }
+    }
+}
+
+}  // namespace yjcServer
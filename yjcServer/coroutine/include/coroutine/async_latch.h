@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+
+/*
+ * 一次性的协程倒计数门闩
+ *   async_latch latch(n);  //n个任务各自count_down()，等待者co_await latch.wait()
+ * 无锁实现: 等待者压入原子栈；计数到0时把栈替换为"已打开"标记，
+ * 反转成FIFO后依次恢复，之后的wait()不再挂起。
+ * 等待者在最后一次count_down的线程上恢复。
+ */
+
+namespace yjcServer {
+
+class async_latch {
+public:
+    class wait_awaiter {
+        friend class async_latch;
+
+    private:
+        async_latch&            m_latch;
+        wait_awaiter*           m_next = nullptr;
+        std::coroutine_handle<> m_handle;
+
+    public:
+        explicit wait_awaiter(async_latch& latch) noexcept : m_latch(latch) {}
+
+        bool await_ready() const noexcept {
+            return m_latch.is_ready();
+        }
+        bool await_suspend(std::coroutine_handle<> handle) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+private:
+    static constexpr std::uintptr_t opened = 1;
+
+    std::atomic<int64_t> m_count;
+    // opened或等待者栈顶(wait_awaiter*)
+    std::atomic<std::uintptr_t> m_waiters{0};
+
+public:
+    explicit async_latch(int64_t count) noexcept : m_count(count) {
+        if (count <= 0) {
+            m_waiters.store(opened, std::memory_order_relaxed);
+        }
+    }
+    async_latch(const async_latch&) = delete;
+    async_latch& operator=(const async_latch&) = delete;
+
+    bool is_ready() const noexcept {
+        return m_waiters.load(std::memory_order_acquire) == opened;
+    }
+
+    /// @brief 计数减n，减到0时恢复所有等待者
+    void count_down(int64_t n = 1);
+
+    /// @brief co_await wait()等待计数到0
+    wait_awaiter wait() noexcept {
+        return wait_awaiter{*this};
+    }
+};
+
+}  // namespace yjcServer
@@ -0,0 +1,107 @@
+#pragma once
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+
+/*
+ * 协程互斥锁，等待锁时挂起协程而不是阻塞线程
+ *   auto guard = co_await mutex.scoped_lock();
+ * 无锁实现: 一个原子状态表示 未加锁/已加锁无等待者/等待者栈顶。
+ * 新的等待者压栈；unlock时持有者把栈整体取下并反转成FIFO链表，
+ * 之后按先来先得的顺序把锁直接交给下一个等待者并恢复它。
+ * 下一个持有者在unlock的线程上恢复。
+ */
+
+namespace yjcServer {
+
+class async_mutex;
+
+/// @brief co_await scoped_lock()的结果，析构时unlock
+class async_lock_guard {
+private:
+    async_mutex* m_mutex;
+
+public:
+    explicit async_lock_guard(async_mutex& mutex) noexcept : m_mutex(&mutex) {}
+    async_lock_guard(async_lock_guard&& other) noexcept
+        : m_mutex(std::exchange(other.m_mutex, nullptr)) {}
+    async_lock_guard(const async_lock_guard&) = delete;
+    async_lock_guard& operator=(const async_lock_guard&) = delete;
+    async_lock_guard& operator=(async_lock_guard&&) = delete;
+    ~async_lock_guard();
+};
+
+class async_mutex {
+private:
+    static constexpr std::uintptr_t not_locked = 1;
+    static constexpr std::uintptr_t locked_no_waiters = 0;
+
+public:
+    class lock_awaiter {
+        friend class async_mutex;
+
+    protected:
+        async_mutex&            m_mutex;
+        lock_awaiter*           m_next = nullptr;
+        std::coroutine_handle<> m_handle;
+
+    public:
+        explicit lock_awaiter(async_mutex& mutex) noexcept : m_mutex(mutex) {}
+
+        bool await_ready() noexcept {
+            return m_mutex.try_lock();
+        }
+        bool await_suspend(std::coroutine_handle<> handle) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+    class scoped_lock_awaiter : public lock_awaiter {
+    public:
+        using lock_awaiter::lock_awaiter;
+
+        [[nodiscard]] async_lock_guard await_resume() const noexcept {
+            return async_lock_guard{m_mutex};
+        }
+    };
+
+private:
+    //not_locked、locked_no_waiters或等待者栈顶(lock_awaiter*)
+    std::atomic<std::uintptr_t> m_state{not_locked};
+    //已经取下并反转好的FIFO等待者，只由持有者访问
+    lock_awaiter* m_waiters = nullptr;
+
+public:
+    async_mutex() noexcept = default;
+    async_mutex(const async_mutex&) = delete;
+    async_mutex& operator=(const async_mutex&) = delete;
+    ~async_mutex();
+
+    bool try_lock() noexcept {
+        std::uintptr_t old = not_locked;
+        return m_state.compare_exchange_strong(old, locked_no_waiters,
+                                               std::memory_order_acquire,
+                                               std::memory_order_relaxed);
+    }
+
+    /// @brief co_await lock()获得锁，之后需要手动unlock
+    lock_awaiter lock() noexcept {
+        return lock_awaiter{*this};
+    }
+
+    /// @brief co_await scoped_lock()获得锁，返回的guard析构时解锁
+    scoped_lock_awaiter scoped_lock() noexcept {
+        return scoped_lock_awaiter{*this};
+    }
+
+    /// @brief 解锁，有等待者时把锁交给最早的一个并恢复它
+    void unlock();
+};
+
+inline async_lock_guard::~async_lock_guard() {
+    if (m_mutex) {
+        m_mutex->unlock();
+    }
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,70 @@
+#pragma once
+#include <thread/Thread.h>
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+
+/*
+ * 协程计数信号量，限制同时使用某种资源(连接池、后端并发数)的协程数
+ *   co_await sem.acquire(); ... sem.release();
+ * 快路径只有一次原子加减；许可不足时等待者按FIFO排队挂起，
+ * 队列只在入队/出队的几条指针操作期间用Spinlock保护，从不跨越挂起。
+ * release时被唤醒的等待者在release的线程上恢复。
+ */
+
+namespace yjcServer {
+
+class async_semaphore {
+public:
+    class acquire_awaiter {
+        friend class async_semaphore;
+
+    private:
+        async_semaphore&        m_semaphore;
+        acquire_awaiter*        m_next = nullptr;
+        std::coroutine_handle<> m_handle;
+
+    public:
+        explicit acquire_awaiter(async_semaphore& semaphore) noexcept
+            : m_semaphore(semaphore) {}
+
+        //先扣减计数，扣减前没有可用许可时才进入await_suspend排队
+        bool await_ready() noexcept {
+            return m_semaphore.m_count.fetch_sub(
+                       1, std::memory_order_acquire) > 0;
+        }
+        bool await_suspend(std::coroutine_handle<> handle) noexcept;
+        void await_resume() const noexcept {}
+    };
+
+private:
+    //>=0为可用许可数，<0时绝对值为欠下的许可数(已经或即将排队的等待者)
+    std::atomic<int64_t> m_count;
+    Spinlock             m_lock;
+    acquire_awaiter*     m_head = nullptr;
+    acquire_awaiter*     m_tail = nullptr;
+    //release时等待者还没来得及入队，许可先记在这里
+    size_t m_handoff = 0;
+
+public:
+    explicit async_semaphore(int64_t initial) noexcept : m_count(initial) {}
+    async_semaphore(const async_semaphore&) = delete;
+    async_semaphore& operator=(const async_semaphore&) = delete;
+
+    bool try_acquire() noexcept;
+
+    /// @brief co_await acquire()获得一个许可
+    acquire_awaiter acquire() noexcept {
+        return acquire_awaiter{*this};
+    }
+
+    /// @brief 归还count个许可，有等待者时按FIFO唤醒
+    void release(int64_t count = 1);
+
+    /// @brief 当前可用许可数，有等待者时为负
+    int64_t available() const noexcept {
+        return m_count.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace yjcServer
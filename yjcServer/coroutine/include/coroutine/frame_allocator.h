@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+
+/*
+ * 协程帧分配器
+ * task<>的promise重载了operator new/delete，协程帧从这里分配:
+ *   ·按大小分级(64B~4KB)，每个线程一组空闲链表，同线程分配/释放无锁无原子操作
+ *   ·帧在A线程分配、B线程释放(CoThreadPool切换线程后结束)时，
+ *    压入A线程缓存的远程释放栈(无锁)，A下次分配时整批取回
+ *   ·超过4KB的帧直接走::operator new
+ * 线程退出时缓存不销毁，挂到孤儿列表里给之后新建的线程复用，
+ * 所以远程释放永远不会访问到已销毁的缓存。
+ */
+
+namespace yjcServer {
+
+class frame_allocator {
+public:
+    static constexpr size_t min_class_size = 64;
+    static constexpr size_t max_class_size = 4096;
+    //每级空闲链表最多缓存的块数，超过的直接还给系统
+    static constexpr size_t max_cached_blocks = 1024;
+
+    static void* allocate(size_t size);
+    static void  deallocate(void* ptr) noexcept;
+
+    /// @brief 当前线程缓存的空闲块数(所有级别之和)
+    static size_t cached_blocks();
+
+    /// @brief 在当前线程的缓存中为每一级预先放入blocks个空闲块
+    static void reserve(size_t blocks);
+};
+
+}  // namespace yjcServer
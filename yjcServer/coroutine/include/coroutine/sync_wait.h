@@ -0,0 +1,115 @@
+#pragma once
+#include <coroutine/task.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <type_traits>
+
+/*
+ * 在普通函数(main/测试)中启动一个task并阻塞等待结果
+ *   int v = sync_wait(compute());                     //当前线程启动，阻塞等待
+ *   sync_wait(IOUring::Instance(), serve(listener));  //驱动事件循环直到结束
+ *   sync_wait(co_pool, work());                        //在执行器上运行
+ * 返回task的结果，task抛出的异常在这里重新抛出。
+ * 驱动事件循环时task必须在该线程上结束，否则循环可能一直阻塞在等待cqe上。
+ */
+
+namespace yjcServer {
+
+/// @brief 事件循环: run_once()处理一批就绪事件，没有时阻塞
+template <class Loop>
+concept run_loop = requires(Loop& loop) { loop.run_once(); };
+
+/// @brief 执行器: co_await schedule()后协程在执行器的线程上继续
+template <class Executor>
+concept scheduler = requires(Executor& executor) { executor.schedule(); };
+
+namespace detail {
+
+/// @brief task结束时通过task_join置位
+class sync_wait_event : public task_join {
+private:
+    std::atomic<bool>       m_done{false};
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+
+    static std::coroutine_handle<> set(task_join* join, std::coroutine_handle<>,
+                                       size_t) noexcept {
+        auto* self = static_cast<sync_wait_event*>(join);
+        //在锁内通知，等待者拿到锁之前不会返回并销毁event
+        std::lock_guard<std::mutex> lock(self->m_mutex);
+        self->m_done.store(true, std::memory_order_release);
+        self->m_cv.notify_one();
+        return std::noop_coroutine();
+    }
+
+public:
+    sync_wait_event() {
+        on_done = &sync_wait_event::set;
+    }
+
+    bool is_set() const noexcept {
+        return m_done.load(std::memory_order_acquire);
+    }
+
+    /// @brief 即使已经置位也要拿一次锁，确保set()已经离开临界区
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] { return is_set(); });
+    }
+};
+
+template <class T>
+using sync_wait_result_t =
+    std::conditional_t<std::is_reference_v<T> || std::is_void_v<T>, T,
+                       std::remove_cvref_t<T>>;
+
+template <class T>
+sync_wait_result_t<T> take_sync_result(task<T>& t) {
+    auto& promise = t.get_handle().promise();
+    if constexpr (std::is_void_v<T> || std::is_reference_v<T>) {
+        return promise.result();
+    } else {
+        return std::move(promise).result();
+    }
+}
+
+template <class T, class Executor>
+task<T> schedule_on(Executor& executor, task<T> t) {
+    co_await executor.schedule();
+    co_return co_await std::move(t);
+}
+
+}  // namespace detail
+
+/// @brief 在当前线程启动t，阻塞直到结束(可以在其他线程上结束)
+template <class T>
+detail::sync_wait_result_t<T> sync_wait(task<T> t) {
+    detail::sync_wait_event event;
+    t.get_handle().promise().set_join(&event);
+    t.get_handle().resume();
+    event.wait();
+    return detail::take_sync_result(t);
+}
+
+/// @brief 在当前线程启动t，并驱动loop直到t结束
+template <run_loop Loop, class T>
+detail::sync_wait_result_t<T> sync_wait(Loop& loop, task<T> t) {
+    detail::sync_wait_event event;
+    t.get_handle().promise().set_join(&event);
+    t.get_handle().resume();
+    while (!event.is_set()) {
+        loop.run_once();
+    }
+    event.wait();
+    return detail::take_sync_result(t);
+}
+
+/// @brief 把t调度到executor上执行，当前线程阻塞直到结束
+template <scheduler Executor, class T>
+requires(!run_loop<Executor>)
+detail::sync_wait_result_t<T> sync_wait(Executor& executor, task<T> t) {
+    return sync_wait(detail::schedule_on(executor, std::move(t)));
+}
+
+}  // namespace yjcServer
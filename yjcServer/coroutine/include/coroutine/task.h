@@ -1,10 +1,12 @@
 #pragma once
 
 #include <Config/util.h>
+#include <coroutine/frame_allocator.h>
 #include <concepts>
 #include <coroutine>
 #include <exception>
 #include <memory>
+#include <utility>
 
 #define YJC_CO_AWAIT_HINT nodiscard("Did you forget to co_await?")
 
@@ -26,6 +28,15 @@ class task;
 template <class T>
 class task_promise_base;
 
+/// @brief 子协程的汇合点(when_all/when_any/task_group)
+/// 设置后子协程结束时不再跳转到父协程，而是调用on_done，
+/// 由它返回下一个要执行的协程(通常是最后一个结束时的等待者，否则noop)
+struct task_join {
+    std::coroutine_handle<> (*on_done)(task_join*              join,
+                                       std::coroutine_handle<> child,
+                                       size_t index) noexcept = nullptr;
+};
+
 //----------------------struct task_final_awaiter--------------------------
 
 /// @brief 子协程结束时恢复其父协程
@@ -39,7 +50,12 @@ struct task_final_awaiter {
     template <std::derived_from<task_promise_base<T>> Promise>
     std::coroutine_handle<>
     await_suspend(std::coroutine_handle<Promise> current) noexcept {
-        return current.promise().m_parent_coro;
+        auto& promise = current.promise();
+        if (promise.m_join) {
+            return promise.m_join->on_done(promise.m_join, current,
+                                           promise.m_join_index);
+        }
+        return promise.m_parent_coro;
     }
     //不会resume
     void await_resume() noexcept {}
@@ -56,7 +72,11 @@ struct task_final_awaiter<void> {
     template <std::derived_from<task_promise_base<void>> Promise>
     std::coroutine_handle<>
     await_suspend(std::coroutine_handle<Promise> current) noexcept {
-        auto&                   promise = current.promise();
+        auto& promise = current.promise();
+        if (promise.m_join) {
+            return promise.m_join->on_done(promise.m_join, current,
+                                           promise.m_join_index);
+        }
         std::coroutine_handle<> parent = promise.m_parent_coro;
         if (promise.m_is_detached_flag == Promise::is_detached) {
             current.destroy();
@@ -77,10 +97,21 @@ class task_promise_base {
 
 private:
     std::coroutine_handle<> m_parent_coro{std::noop_coroutine()};
+    task_join*              m_join = nullptr;
+    size_t                  m_join_index = 0;
 
 public:
     task_promise_base() noexcept = default;
 
+    //协程帧从线程缓存的分级空闲链表分配
+    static void* operator new(std::size_t size) {
+        return frame_allocator::allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t) noexcept {
+        frame_allocator::deallocate(ptr);
+    }
+
     //惰性协程，创建时不会立即执行
     std::suspend_always initial_suspend() noexcept {
         return {};
@@ -94,6 +125,12 @@ public:
         m_parent_coro = parent;
     }
 
+    /// @brief 结束时通知join而不是恢复父协程，index原样传给on_done
+    void set_join(task_join* join, size_t index = 0) {
+        m_join = join;
+        m_join_index = index;
+    }
+
     //禁止拷贝/移动
     task_promise_base(const task_promise_base&) = delete;
     task_promise_base(task_promise_base&&) = delete;
@@ -117,10 +154,10 @@ public:
     // union必须手动选择析构
     ~task_promise() noexcept {
         switch (m_state) {
-            [[likely]] case value_state::value : value.~T();
+            [[likely]] case value_state::value : m_value.~T();
             break;
         case value_state::exception:
-            exception_ptr.~exception_ptr();
+            m_exception_ptr.~exception_ptr();
             break;
         default:
             break;
@@ -140,7 +177,7 @@ public:
     requires std::convertible_to<Value&&, T>
     void return_value(Value&& result) noexcept(
         std::is_nothrow_constructible_v<T, Value&&>) {
-        std::construct_at(std::addressof(value),
+        std::construct_at(std::addressof(m_value),
                           std::forward<Value>(result));  //原地构造，union需要
         m_state = value_state::value;
     }
@@ -248,7 +285,7 @@ private:
     struct awaiter_base {
         std::coroutine_handle<promise_type> handle;
 
-        explicit await_base(std::coroutine_handle<promise_type> current)
+        explicit awaiter_base(std::coroutine_handle<promise_type> current)
             : handle(current) {}
 
         bool await_ready() const noexcept {
@@ -268,20 +305,20 @@ public:
     explicit task(std::coroutine_handle<promise_type> current) noexcept
         : m_handle(current) {}
 
-    task(task&& other) noexcept : m_handle(other.handle) {
-        other.handle = nullptr;
+    task(task&& other) noexcept : m_handle(other.m_handle) {
+        other.m_handle = nullptr;
     }
 
     // Ban copy
-    task(const task<>&) = delete;
+    task(const task&) = delete;
     task& operator=(const task&) = delete;
 
     task& operator=(task&& other) noexcept {
         if (this != std::addressof(other)) [[likely]] {
-            if (handle) {
+            if (m_handle) {
                 m_handle.destroy();
             }
-            handle = other.m_handle;
+            m_handle = other.m_handle;
             other.m_handle = nullptr;
         }
         return *this;
@@ -289,21 +326,23 @@ public:
 
     // Free the promise object and coroutine parameters
     ~task() {
-        if (handle) {
+        if (m_handle) {
             m_handle.destroy();
         }
     }
 
     [[nodiscard]] bool is_ready() const noexcept {
-        return !handle || handle.done();
+        return !m_handle || m_handle.done();
     }
 
     /// @brief 使用co_await task<>切换到此协程中，在协程结束后回来并返回ref
     auto operator co_await() const& noexcept {
         struct awaiter : awaiter_base {
+            using awaiter_base::awaiter_base;
+
             decltype(auto) await_resume() {
-                YJC_ASSERT(handle);
-                return handle.promise().result();
+                YJC_ASSERT(static_cast<bool>(this->handle));
+                return this->handle.promise().result();
             }
         };
         return awaiter{m_handle};
@@ -313,9 +352,11 @@ public:
     /// ref
     auto operator co_await() const&& noexcept {
         struct awaiter : awaiter_base {
+            using awaiter_base::awaiter_base;
+
             decltype(auto) await_resume() {
-                YJC_ASSERT(handle);
-                return std::move(handle.promise()).result();
+                YJC_ASSERT(static_cast<bool>(this->handle));
+                return std::move(this->handle.promise()).result();
             }
         };
         return awaiter{m_handle};
@@ -333,7 +374,12 @@ public:
     }
 
     std::coroutine_handle<promise_type> get_handle() noexcept {
-        return handle;
+        return m_handle;
+    }
+
+    /// @brief 交出协程帧的所有权，调用者负责destroy
+    [[nodiscard]] std::coroutine_handle<promise_type> release() noexcept {
+        return std::exchange(m_handle, nullptr);
     }
 
     void detach() noexcept {
@@ -0,0 +1,70 @@
+#pragma once
+#include <coroutine/task.h>
+#include <atomic>
+#include <coroutine>
+#include <exception>
+
+/*
+ * 结构化并发的nursery
+ *   task_group group;
+ *   for (auto& conn : conns) group.spawn(handle(conn));
+ *   co_await group.join();
+ * spawn立即在当前线程启动子协程，运行到第一个挂起点后返回；子协程数量不限，
+ * 每个结束的子协程立即销毁自己的帧，只有一个原子计数，没有额外分配。
+ * join等待所有子协程结束，之后重新抛出第一个子协程异常。
+ * group销毁前必须join；join期间不能再spawn。
+ */
+
+namespace yjcServer {
+
+class task_group : private task_join {
+private:
+    //初始为1，代表join自己，最后减到0的一方恢复等待者
+    std::atomic<size_t>     m_count{1};
+    std::coroutine_handle<> m_waiter;
+    std::atomic<bool>       m_failed{false};
+    std::exception_ptr      m_exception;
+
+    static std::coroutine_handle<> child_done(task_join*              join,
+                                              std::coroutine_handle<> child,
+                                              size_t) noexcept;
+
+public:
+    task_group() {
+        on_done = &task_group::child_done;
+    }
+    ~task_group();
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    /// @brief 启动子协程，group接管它的帧
+    void spawn(task<> child);
+
+    /// @brief 正在运行的子协程数
+    size_t size() const {
+        return m_count.load(std::memory_order_acquire) - 1;
+    }
+
+    class join_awaiter {
+    private:
+        task_group& m_group;
+
+    public:
+        explicit join_awaiter(task_group& group) : m_group(group) {}
+
+        bool await_ready() const noexcept {
+            return m_group.size() == 0;
+        }
+        bool await_suspend(std::coroutine_handle<> waiter) noexcept;
+        /// @brief 有子协程抛出异常时重新抛出第一个
+        void await_resume();
+    };
+
+    /// @brief 等待所有子协程结束，之后group可以继续spawn
+    join_awaiter join() {
+        return join_awaiter{*this};
+    }
+};
+
+}  // namespace yjcServer
@@ -0,0 +1,146 @@
+#pragma once
+#include <coroutine/task.h>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+/*
+ * 并发等待多个task
+ *   auto [a, b] = co_await when_all(fetch_a(), fetch_b());
+ *   std::vector<int> res = co_await when_all(std::move(tasks));
+ * 子协程依次启动，遇到第一个挂起点就返回启动下一个；计数器初始为N+1，
+ * 每个子协程结束减一，等待者启动完后也减一，减到0的一方跳转(对称转移)到
+ * 等待者，不需要任何堆分配的回调。
+ * 所有子协程结束后才返回，按参数顺序取结果，其中的异常按顺序重新抛出第一个。
+ */
+
+namespace yjcServer {
+
+/// @brief when_all结果中元素的类型，void用std::monostate占位，引用用reference_wrapper
+template <class T>
+using when_all_result_t = std::conditional_t<
+    std::is_void_v<T>, std::monostate,
+    std::conditional_t<std::is_reference_v<T>,
+                       std::reference_wrapper<std::remove_reference_t<T>>,
+                       T>>;
+
+namespace detail {
+
+/// @brief 子协程的汇合计数器
+class when_all_counter : public task_join {
+private:
+    std::atomic<size_t>     m_count;
+    std::coroutine_handle<> m_waiter;
+
+    static std::coroutine_handle<> arrive(task_join* join,
+                                          std::coroutine_handle<>,
+                                          size_t) noexcept {
+        auto* self = static_cast<when_all_counter*>(join);
+        if (self->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            return self->m_waiter;
+        }
+        return std::noop_coroutine();
+    }
+
+public:
+    explicit when_all_counter(size_t count) : m_count(count + 1) {
+        on_done = &when_all_counter::arrive;
+    }
+
+    /// @brief 等待者启动完所有子协程后调用，返回true表示需要挂起
+    bool try_await(std::coroutine_handle<> waiter) noexcept {
+        m_waiter = waiter;
+        return m_count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+};
+
+inline std::coroutine_handle<> handle_of(std::coroutine_handle<> handle) {
+    return handle;
+}
+
+template <class T>
+std::coroutine_handle<> handle_of(task<T>& t) {
+    return t.get_handle();
+}
+
+/// @brief 依次启动Children中的协程，全部结束后恢复等待者
+/// @tparam Children 协程句柄数组或task<T>的span
+template <class Children>
+class when_all_awaiter {
+private:
+    Children         m_children;
+    when_all_counter m_counter;
+
+public:
+    explicit when_all_awaiter(Children children)
+        : m_children(std::move(children)), m_counter(std::size(m_children)) {}
+
+    bool await_ready() const noexcept {
+        return std::size(m_children) == 0;
+    }
+
+    bool await_suspend(std::coroutine_handle<> waiter) {
+        for (auto& child : m_children) {
+            handle_of(child).resume();
+        }
+        return m_counter.try_await(waiter);
+    }
+
+    void await_resume() const noexcept {}
+
+    when_all_counter& counter() {
+        return m_counter;
+    }
+};
+
+/// @brief 从已结束的task中取出结果，有异常时重新抛出
+template <class T>
+when_all_result_t<T> take_result(task<T>& t) {
+    auto& promise = t.get_handle().promise();
+    if constexpr (std::is_void_v<T>) {
+        promise.result();
+        return {};
+    } else if constexpr (std::is_reference_v<T>) {
+        return promise.result();
+    } else {
+        return std::move(promise).result();
+    }
+}
+
+}  // namespace detail
+
+/// @brief 并发执行所有task，返回按参数顺序排列的结果
+template <class... Ts>
+task<std::tuple<when_all_result_t<Ts>...>> when_all(task<Ts>... tasks) {
+    std::array<std::coroutine_handle<>, sizeof...(Ts)> handles{
+        tasks.get_handle()...};
+    detail::when_all_awaiter awaiter(handles);
+    (tasks.get_handle().promise().set_join(&awaiter.counter()), ...);
+    co_await awaiter;
+    co_return std::tuple<when_all_result_t<Ts>...>{
+        detail::take_result(tasks)...};
+}
+
+/// @brief 并发执行range中的所有task，返回按顺序排列的结果
+template <class T>
+task<std::vector<when_all_result_t<T>>> when_all(std::vector<task<T>> tasks) {
+    detail::when_all_awaiter awaiter{std::span<task<T>>(tasks)};
+    for (task<T>& t : tasks) {
+        t.get_handle().promise().set_join(&awaiter.counter());
+    }
+    co_await awaiter;
+
+    std::vector<when_all_result_t<T>> results;
+    results.reserve(tasks.size());
+    for (task<T>& t : tasks) {
+        results.push_back(detail::take_result(t));
+    }
+    co_return results;
+}
+
+}  // namespace yjcServer
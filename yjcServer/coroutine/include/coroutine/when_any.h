@@ -0,0 +1,132 @@
+#pragma once
+#include <coroutine/when_all.h>
+#include <atomic>
+#include <vector>
+
+/*
+ * 等待多个task中第一个结束的
+ *   auto [index, value] = co_await when_any(std::move(tasks));
+ * 第一个结束的子协程对称转移到等待者；其余子协程继续执行到结束，
+ * 它们的帧由一块共享状态持有(引用计数=子协程数+等待者)，最后一个
+ * 离开的负责销毁，所以等待者返回后不需要等剩下的子协程。
+ * 没有取消机制，需要提前结束其余子协程时由调用者自己通知它们。
+ */
+
+namespace yjcServer {
+
+/// @brief when_any的结果: 第一个结束的task的下标和它的结果
+template <class T>
+struct when_any_result {
+    size_t               index;
+    when_all_result_t<T> value;
+};
+
+template <>
+struct when_any_result<void> {
+    size_t index;
+};
+
+namespace detail {
+
+template <class T>
+class when_any_state : public task_join {
+private:
+    std::vector<task<T>>    m_tasks;
+    std::atomic<size_t>     m_refs;
+    std::atomic<bool>       m_finished{false};
+    //第一个结束的子协程和等待者都到达后才恢复等待者，防止启动过程中被恢复
+    std::atomic<int>        m_wake{2};
+    size_t                  m_winner = 0;
+    std::coroutine_handle<> m_waiter;
+
+    static std::coroutine_handle<> arrive(task_join* join,
+                                          std::coroutine_handle<>,
+                                          size_t index) noexcept {
+        auto*                   self = static_cast<when_any_state*>(join);
+        std::coroutine_handle<> next = std::noop_coroutine();
+        if (!self->m_finished.exchange(true, std::memory_order_acq_rel)) {
+            self->m_winner = index;
+            if (self->m_wake.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                next = self->m_waiter;
+            }
+        }
+        //可能销毁当前子协程自己的帧，之后不能再访问promise
+        self->release();
+        return next;
+    }
+
+public:
+    explicit when_any_state(std::vector<task<T>> tasks)
+        : m_tasks(std::move(tasks)), m_refs(m_tasks.size() + 1) {
+        on_done = &when_any_state::arrive;
+        for (size_t i = 0; i < m_tasks.size(); ++i) {
+            m_tasks[i].get_handle().promise().set_join(this, i);
+        }
+    }
+
+    void release() noexcept {
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> waiter) {
+        m_waiter = waiter;
+        for (task<T>& t : m_tasks) {
+            t.get_handle().resume();
+        }
+        return m_wake.fetch_sub(1, std::memory_order_acq_rel) > 1;
+    }
+
+    size_t await_resume() const noexcept {
+        return m_winner;
+    }
+
+    task<T>& winner() {
+        return m_tasks[m_winner];
+    }
+};
+
+/// @brief 等待者持有的引用
+template <class T>
+struct when_any_state_ref {
+    when_any_state<T>* state;
+
+    ~when_any_state_ref() {
+        state->release();
+    }
+};
+
+}  // namespace detail
+
+/// @brief 并发执行tasks，返回第一个结束的下标和结果，tasks不能为空
+template <class T>
+task<when_any_result<T>> when_any(std::vector<task<T>> tasks) {
+    YJC_ASSERT(!tasks.empty());
+    detail::when_any_state_ref<T> ref{
+        new detail::when_any_state<T>(std::move(tasks))};
+    const size_t index = co_await *ref.state;
+    if constexpr (std::is_void_v<T>) {
+        detail::take_result(ref.state->winner());
+        co_return when_any_result<T>{index};
+    } else {
+        co_return when_any_result<T>{index,
+                                     detail::take_result(ref.state->winner())};
+    }
+}
+
+template <class T, class... Ts>
+requires(std::same_as<T, Ts> && ...)
+task<when_any_result<T>> when_any(task<T> first, task<Ts>... rest) {
+    std::vector<task<T>> tasks;
+    tasks.reserve(sizeof...(Ts) + 1);
+    tasks.push_back(std::move(first));
+    (tasks.push_back(std::move(rest)), ...);
+    return when_any(std::move(tasks));
+}
+
+}  // namespace yjcServer
@@ -13,7 +13,8 @@ bool CoThreadPool::schedule_awaiter::await_ready() {
 
 void CoThreadPool::schedule_awaiter::await_suspend(
     std::coroutine_handle<> handle) {
-    m_pool.push_task([&] { handle.resume(); });
+    this->handle = handle;
+    m_pool.schedule(this);
 }
 
 CoThreadPool::schedule_awaiter CoThreadPool::schedule() {
@@ -0,0 +1,42 @@
+#include <coroutine/async_latch.h>
+
+namespace yjcServer {
+
+bool async_latch::wait_awaiter::await_suspend(
+    std::coroutine_handle<> handle) noexcept {
+    m_handle = handle;
+    std::uintptr_t old = m_latch.m_waiters.load(std::memory_order_acquire);
+    do {
+        if (old == opened) {
+            return false;
+        }
+        m_next = reinterpret_cast<wait_awaiter*>(old);
+    } while (!m_latch.m_waiters.compare_exchange_weak(
+        old, reinterpret_cast<std::uintptr_t>(this),
+        std::memory_order_acq_rel, std::memory_order_acquire));
+    return true;
+}
+
+void async_latch::count_down(int64_t n) {
+    const int64_t prev = m_count.fetch_sub(n, std::memory_order_acq_rel);
+    if (prev <= 0 || prev - n > 0) {
+        return;
+    }
+    const std::uintptr_t old =
+        m_waiters.exchange(opened, std::memory_order_acq_rel);
+    //栈是后进先出，反转后按等待顺序恢复
+    wait_awaiter* head = nullptr;
+    for (auto* waiter = reinterpret_cast<wait_awaiter*>(old); waiter;) {
+        wait_awaiter* next = waiter->m_next;
+        waiter->m_next = head;
+        head = waiter;
+        waiter = next;
+    }
+    while (head) {
+        wait_awaiter* next = head->m_next;
+        head->m_handle.resume();
+        head = next;
+    }
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,60 @@
+#include <Config/util.h>
+#include <coroutine/async_mutex.h>
+
+namespace yjcServer {
+
+async_mutex::~async_mutex() {
+    const std::uintptr_t state = m_state.load(std::memory_order_relaxed);
+    YJC_ASSERT_MSG(state == not_locked || state == locked_no_waiters,
+                   "async_mutex destroyed with waiters");
+    YJC_ASSERT_MSG(m_waiters == nullptr, "async_mutex destroyed with waiters");
+}
+
+bool async_mutex::lock_awaiter::await_suspend(
+    std::coroutine_handle<> handle) noexcept {
+    m_handle = handle;
+    std::uintptr_t old = m_mutex.m_state.load(std::memory_order_acquire);
+    while (true) {
+        if (old == not_locked) {
+            //在此期间锁被释放了，直接拿到锁不挂起
+            if (m_mutex.m_state.compare_exchange_weak(
+                    old, locked_no_waiters, std::memory_order_acquire,
+                    std::memory_order_relaxed)) {
+                return false;
+            }
+        } else {
+            m_next = reinterpret_cast<lock_awaiter*>(old);
+            if (m_mutex.m_state.compare_exchange_weak(
+                    old, reinterpret_cast<std::uintptr_t>(this),
+                    std::memory_order_release, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+}
+
+void async_mutex::unlock() {
+    YJC_ASSERT(m_state.load(std::memory_order_relaxed) != not_locked);
+    lock_awaiter* head = m_waiters;
+    if (head == nullptr) {
+        std::uintptr_t old = locked_no_waiters;
+        if (m_state.compare_exchange_strong(old, not_locked,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+            return;
+        }
+        //取下所有新等待者，反转成FIFO
+        old = m_state.exchange(locked_no_waiters, std::memory_order_acquire);
+        auto* waiter = reinterpret_cast<lock_awaiter*>(old);
+        do {
+            lock_awaiter* next = waiter->m_next;
+            waiter->m_next = head;
+            head = waiter;
+            waiter = next;
+        } while (waiter);
+    }
+    m_waiters = head->m_next;
+    head->m_handle.resume();
+}
+
+}  // namespace yjcServer
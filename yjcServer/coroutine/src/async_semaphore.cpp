@@ -0,0 +1,61 @@
+#include <coroutine/async_semaphore.h>
+#include <mutex>
+
+namespace yjcServer {
+
+bool async_semaphore::try_acquire() noexcept {
+    int64_t count = m_count.load(std::memory_order_relaxed);
+    while (count > 0) {
+        if (m_count.compare_exchange_weak(count, count - 1,
+                                          std::memory_order_acquire,
+                                          std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool async_semaphore::acquire_awaiter::await_suspend(
+    std::coroutine_handle<> handle) noexcept {
+    std::lock_guard<Spinlock> lock(m_semaphore.m_lock);
+    if (m_semaphore.m_handoff > 0) {
+        --m_semaphore.m_handoff;
+        return false;
+    }
+    m_handle = handle;
+    m_next = nullptr;
+    if (m_semaphore.m_tail) {
+        m_semaphore.m_tail->m_next = this;
+    } else {
+        m_semaphore.m_head = this;
+    }
+    m_semaphore.m_tail = this;
+    return true;
+}
+
+void async_semaphore::release(int64_t count) {
+    for (; count > 0; --count) {
+        if (m_count.fetch_add(1, std::memory_order_release) >= 0) {
+            continue;
+        }
+        //有欠下的许可，交给最早的等待者
+        acquire_awaiter* waiter;
+        {
+            std::lock_guard<Spinlock> lock(m_lock);
+            waiter = m_head;
+            if (waiter) {
+                m_head = waiter->m_next;
+                if (m_head == nullptr) {
+                    m_tail = nullptr;
+                }
+            } else {
+                ++m_handoff;
+            }
+        }
+        if (waiter) {
+            waiter->m_handle.resume();
+        }
+    }
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,208 @@
+#include <coroutine/frame_allocator.h>
+#include <thread/Thread.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace yjcServer {
+
+namespace {
+
+constexpr size_t class_count =
+    std::bit_width(frame_allocator::max_class_size) -
+    std::bit_width(frame_allocator::min_class_size) + 1;
+
+//线程池预热时每一级预先缓存的块数
+constexpr size_t warmup_blocks = 16;
+
+struct frame_cache;
+
+/// @brief 每个块前面的头，记录所属缓存和级别
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block_header {
+    frame_cache* owner;  // nullptr表示大块，直接::operator delete
+    uint32_t     size_class;
+};
+
+//空闲时复用帧的空间存放链表指针
+struct free_block {
+    block_header header;
+    free_block*  next;
+};
+
+struct frame_cache {
+    free_block* free_list[class_count]{};
+    size_t      free_count[class_count]{};
+    //其他线程释放的块，MPSC栈，只有所属线程整批取走
+    std::atomic<free_block*> remote{nullptr};
+    frame_cache*             next_orphan = nullptr;
+
+    void push_local(free_block* block) {
+        const uint32_t c = block->header.size_class;
+        if (free_count[c] >= frame_allocator::max_cached_blocks) {
+            ::operator delete(block);
+            return;
+        }
+        block->next = free_list[c];
+        free_list[c] = block;
+        ++free_count[c];
+    }
+
+    free_block* pop_local(uint32_t c) {
+        free_block* block = free_list[c];
+        if (block) {
+            free_list[c] = block->next;
+            --free_count[c];
+        }
+        return block;
+    }
+
+    void push_remote(free_block* block) {
+        free_block* head = remote.load(std::memory_order_relaxed);
+        do {
+            block->next = head;
+        } while (!remote.compare_exchange_weak(head, block,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+    }
+
+    void drain_remote() {
+        free_block* block = remote.exchange(nullptr, std::memory_order_acquire);
+        while (block) {
+            free_block* next = block->next;
+            push_local(block);
+            block = next;
+        }
+    }
+};
+
+//退出线程留下的缓存，新线程优先复用
+std::mutex   s_orphan_mutex;
+frame_cache* s_orphans = nullptr;
+
+thread_local frame_cache* t_cache = nullptr;
+thread_local bool         t_exited = false;
+
+struct cache_holder {
+    ~cache_holder() {
+        if (t_cache) {
+            std::lock_guard<std::mutex> lock(s_orphan_mutex);
+            t_cache->next_orphan = s_orphans;
+            s_orphans = t_cache;
+        }
+        t_cache = nullptr;
+        t_exited = true;
+    }
+};
+
+/// @brief 当前线程的缓存，线程退出过程中返回nullptr
+frame_cache* local_cache() {
+    if (t_cache == nullptr && !t_exited) {
+        thread_local cache_holder holder;
+        {
+            std::lock_guard<std::mutex> lock(s_orphan_mutex);
+            if (s_orphans) {
+                t_cache = s_orphans;
+                s_orphans = t_cache->next_orphan;
+                t_cache->next_orphan = nullptr;
+            }
+        }
+        if (t_cache == nullptr) {
+            t_cache = new frame_cache;
+        }
+    }
+    return t_cache;
+}
+
+uint32_t size_class_of(size_t block_size) {
+    if (block_size <= frame_allocator::min_class_size) {
+        return 0;
+    }
+    return std::bit_width(block_size - 1) -
+           std::bit_width(frame_allocator::min_class_size - 1);
+}
+
+}  // namespace
+
+void* frame_allocator::allocate(size_t size) {
+    const size_t  block_size = size + sizeof(block_header);
+    frame_cache*  cache = local_cache();
+    block_header* header;
+    if (block_size > max_class_size || cache == nullptr) {
+        header = static_cast<block_header*>(::operator new(block_size));
+        header->owner = nullptr;
+        header->size_class = 0;
+        return header + 1;
+    }
+
+    const uint32_t c = size_class_of(block_size);
+    free_block*    block = cache->pop_local(c);
+    if (block == nullptr &&
+        cache->remote.load(std::memory_order_relaxed) != nullptr) {
+        cache->drain_remote();
+        block = cache->pop_local(c);
+    }
+    if (block) {
+        header = &block->header;
+    } else {
+        header =
+            static_cast<block_header*>(::operator new(min_class_size << c));
+        header->owner = cache;
+        header->size_class = c;
+    }
+    return header + 1;
+}
+
+void frame_allocator::deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    block_header* header = static_cast<block_header*>(ptr) - 1;
+    frame_cache*  owner = header->owner;
+    if (owner == nullptr) {
+        ::operator delete(header);
+    } else if (owner == t_cache) {
+        owner->push_local(reinterpret_cast<free_block*>(header));
+    } else {
+        owner->push_remote(reinterpret_cast<free_block*>(header));
+    }
+}
+
+void frame_allocator::reserve(size_t blocks) {
+    frame_cache* cache = local_cache();
+    if (cache == nullptr) {
+        return;
+    }
+    blocks = std::min(blocks, max_cached_blocks);
+    for (uint32_t c = 0; c < class_count; ++c) {
+        while (cache->free_count[c] < blocks) {
+            auto* block =
+                static_cast<free_block*>(::operator new(min_class_size << c));
+            block->header.owner = cache;
+            block->header.size_class = c;
+            cache->push_local(block);
+        }
+    }
+}
+
+//线程池预热时预先填充工作线程的帧缓存
+static const bool warmup_registered = [] {
+    Thread::AddWarmup([] { frame_allocator::reserve(warmup_blocks); });
+    return true;
+}();
+
+size_t frame_allocator::cached_blocks() {
+    frame_cache* cache = t_cache;
+    if (cache == nullptr) {
+        return 0;
+    }
+    size_t count = 0;
+    for (size_t c = 0; c < class_count; ++c) {
+        count += cache->free_count[c];
+    }
+    return count;
+}
+
+}  // namespace yjcServer
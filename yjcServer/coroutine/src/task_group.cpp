@@ -0,0 +1,51 @@
+#include <coroutine/task_group.h>
+
+namespace yjcServer {
+
+task_group::~task_group() {
+    YJC_ASSERT_MSG(size() == 0, "task_group destroyed before join");
+}
+
+std::coroutine_handle<> task_group::child_done(task_join*              join,
+                                               std::coroutine_handle<> child,
+                                               size_t) noexcept {
+    auto* self = static_cast<task_group*>(join);
+    auto  handle =
+        std::coroutine_handle<task_promise<void>>::from_address(child.address());
+    try {
+        handle.promise().result();
+    } catch (...) {
+        if (!self->m_failed.exchange(true, std::memory_order_relaxed)) {
+            self->m_exception = std::current_exception();
+        }
+    }
+    handle.destroy();
+    //减到0后group可能立即被等待者销毁，之后不能再访问self
+    if (self->m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        return self->m_waiter;
+    }
+    return std::noop_coroutine();
+}
+
+void task_group::spawn(task<> child) {
+    auto handle = child.release();
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    handle.promise().set_join(this);
+    handle.resume();
+}
+
+bool task_group::join_awaiter::await_suspend(
+    std::coroutine_handle<> waiter) noexcept {
+    m_group.m_waiter = waiter;
+    //返回false表示子协程在此之前已经全部结束
+    return m_group.m_count.fetch_sub(1, std::memory_order_acq_rel) > 1;
+}
+
+void task_group::join_awaiter::await_resume() {
+    m_group.m_count.store(1, std::memory_order_relaxed);
+    if (m_group.m_failed.exchange(false, std::memory_order_acquire)) {
+        std::rethrow_exception(std::exchange(m_group.m_exception, nullptr));
+    }
+}
+
+}  // namespace yjcServer
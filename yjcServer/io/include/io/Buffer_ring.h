@@ -1,6 +1,7 @@
 #pragma once
 #include <liburing.h>
 #include <bitset>
+#include <cstdlib>
 #include <memory>
 #include <span>
 #include <vector>
@@ -11,9 +12,15 @@ namespace yjcServer {
 //环形缓冲区
 class Buffer_ring {
 private:
-    std::unique_ptr<io_uring_buf_ring> m_buf_ring;
-    std::vector<std::vector<char>>     m_buf_list;
-    std::bitset<MAX_BUFFER_RING_SIZE>  m_borrowed_buf_set;
+    // posix_memalign申请的内存，需要用free释放
+    struct buf_ring_deleter {
+        void operator()(io_uring_buf_ring* p) const {
+            free(p);
+        }
+    };
+    std::unique_ptr<io_uring_buf_ring, buf_ring_deleter> m_buf_ring;
+    std::vector<std::vector<char>>                       m_buf_list;
+    std::bitset<MAX_BUFFER_RING_SIZE>                    m_borrowed_buf_set;
 
 public:
     /// @brief 线程单例
@@ -3,17 +3,22 @@
 #include <span>
 #include <vector>
 
+#define BUFFER_GROUP_ID 0  // Buffer_ring注册的缓冲区组
+
 namespace yjcServer {
 
+/// @brief sqe的user_data，cqe完成时写回结果并恢复handle对应的协程
 struct SqeData {
     void*        handle = 0;
     int          cqe_res = 0;
     unsigned int cqe_flag = 0;
+    /// 非空时cqe交给它处理，而不是直接恢复handle(multishot排队、批量计数等)
+    void (*on_cqe)(SqeData* data) = nullptr;
 };
 
 class IOUring {
 private:
-    struct io_uring* m_ring;
+    struct io_uring m_ring;
 
     IOUring();
     ~IOUring();
@@ -27,7 +32,18 @@ public:
     /// @brief 获取IOUirng的单例对象
     static IOUring& Instance();
     /// @brief 获取原始的io_uring
-    io_uring* get() const;
+    io_uring* get();
+
+    /// @brief 获取一个sqe，提交队列满时先提交再获取
+    io_uring_sqe* get_sqe();
+
+    /// @brief 提交所有sqe
+    int submit();
+
+    /// @brief 提交sqe并分发已完成的cqe
+    /// @param wait 为true时至少等待一个cqe
+    /// @return 分发的cqe数量
+    unsigned run_once(bool wait = true);
 
     /// @brief 内核注册io_uring_buf_ring，用于提供缓冲区
     /// @param buf_ring 要注册的缓冲区
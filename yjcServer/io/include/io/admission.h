@@ -0,0 +1,155 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/*
+ * 准入控制/过载保护(每个reactor线程一个实例)
+ * 三类资源各有上限，阈值来自配置项admission.*，可以在运行时修改:
+ *   ·连接数    超过max_connections后accept循环co_await accept_slot()挂起，
+ *              不再重新提交multishot accept，连接数回落到低水位后恢复
+ *   ·在途请求  try_begin_request()失败时直接返回reject_response()(503)
+ *   ·借用缓冲区 超过max_borrowed_buffers后，占用超过公平份额的连接
+ *              co_await recv_slot()暂停接收，回落到低水位后按先后顺序恢复
+ * 0表示不限制。
+ * 修改后各reactor在事件循环(IOUring::run_once)中调用poll()重新检查挂起的accept循环
+ * 和暂停的连接；有挂起的等待者时事件循环最多阻塞ADMISSION_TICK_MS毫秒，新阈值在这之内生效。
+ */
+
+#define ADMISSION_TICK_MS 100  //有挂起的等待者时，事件循环每次最多阻塞的毫秒数
+
+namespace yjcServer {
+
+class Admission;
+
+/// @brief 连接级的准入状态，由连接对象持有
+class admission_conn {
+    friend class Admission;
+
+private:
+    size_t                  m_borrowed = 0;  //当前借用的缓冲区数
+    std::coroutine_handle<> m_waiter;        //暂停接收时挂起的协程
+    admission_conn*         m_next = nullptr;
+    bool                    m_paused = false;
+
+public:
+    size_t borrowed() const {
+        return m_borrowed;
+    }
+    bool paused() const {
+        return m_paused;
+    }
+};
+
+class Admission {
+private:
+    size_t m_connections = 0;
+    size_t m_inflight = 0;
+    size_t m_borrowed = 0;
+
+    std::coroutine_handle<> m_accept_waiter;
+    //暂停接收的连接，FIFO
+    admission_conn* m_paused_head = nullptr;
+    admission_conn* m_paused_tail = nullptr;
+    uint64_t        m_generation = 0;  //上次检查时的阈值版本
+
+    Admission() = default;
+
+    void maybe_resume_accept();
+    void maybe_resume_recv();
+
+public:
+    Admission(const Admission&) = delete;
+    Admission& operator=(const Admission&) = delete;
+
+    /// @brief 线程单例
+    static Admission& Instance();
+
+    /// @brief 事件循环每轮调用，阈值变化后恢复已经不再超限的等待者
+    void poll();
+
+    /// @brief 是否有挂起的accept循环或者暂停接收的连接
+    bool has_waiters() const {
+        return m_accept_waiter || m_paused_head;
+    }
+
+    //------------------------连接---------------------------
+
+    /// @brief 是否还能接受新连接
+    bool can_accept() const;
+
+    struct accept_awaiter {
+        Admission& admission;
+
+        bool await_ready() const {
+            return admission.can_accept();
+        }
+        void await_suspend(std::coroutine_handle<> handle) {
+            admission.m_accept_waiter = handle;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    /// @brief accept循环在重新提交multishot accept前co_await，
+    /// 连接数超限时挂起直到回落到低水位
+    accept_awaiter accept_slot() {
+        return {*this};
+    }
+
+    /// @brief 新连接建立，超过上限返回false(调用者应直接关闭该连接)
+    bool add_connection();
+
+    /// @brief 连接关闭
+    void remove_connection();
+
+    //------------------------请求---------------------------
+
+    /// @brief 开始处理一个请求，超限返回false，调用者应回复503
+    bool try_begin_request();
+
+    void end_request();
+
+    /// @brief 预先生成的503响应
+    static std::span<const char> reject_response();
+
+    //-----------------------缓冲区--------------------------
+
+    /// @brief conn借用了一个provided buffer
+    /// @return true表示conn是噪声连接，应当co_await recv_slot(conn)暂停接收
+    bool borrow(admission_conn& conn);
+
+    /// @brief conn归还了一个provided buffer
+    void giveback(admission_conn& conn);
+
+    /// @brief 连接关闭时调用，归还计数并移出暂停队列
+    void detach(admission_conn& conn);
+
+    struct recv_awaiter {
+        Admission&      admission;
+        admission_conn& conn;
+
+        bool await_ready() const;
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    /// @brief 暂停conn的接收，直到借用缓冲区回落到低水位
+    recv_awaiter recv_slot(admission_conn& conn) {
+        return {*this, conn};
+    }
+
+    //------------------------统计---------------------------
+
+    size_t connections() const {
+        return m_connections;
+    }
+    size_t inflight_requests() const {
+        return m_inflight;
+    }
+    size_t borrowed_buffers() const {
+        return m_borrowed;
+    }
+};
+
+}  // namespace yjcServer
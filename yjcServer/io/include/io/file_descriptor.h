@@ -1,5 +1,5 @@
 #pragma once
-#include <io/IOUring.h>
+#include <io/io_awaiter.h>
 #include <optional>
 
 namespace yjcServer {
@@ -21,9 +21,11 @@ public:
 
     int get_raw_fd() const;
 
-    class splice_awaiter {
-        
-    };
+    /// @brief 从本fd向out零拷贝搬运最多nbytes字节(其中一端需要是管道)
+    /// @return co_await得到搬运的字节数，失败为-errno
+    auto splice(const file_descriptor& out, unsigned int nbytes) const {
+        return async_splice(get_raw_fd(), -1, out.get_raw_fd(), -1, nbytes);
+    }
 };
 
 }  // namespace yjcServer
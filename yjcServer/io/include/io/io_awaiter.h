@@ -0,0 +1,181 @@
+#pragma once
+#include <io/IOUring.h>
+#include <sys/socket.h>
+#include <array>
+#include <coroutine>
+#include <cstddef>
+#include <span>
+#include <tuple>
+#include <utility>
+
+/*
+ * 通用io_uring操作awaiter
+ * 每种操作只需要提供一个prep可调用对象 void(io_uring_sqe*)：
+ *   int n = co_await io_op([&](io_uring_sqe* sqe) {
+ *       io_uring_prep_recv(sqe, fd, buf.data(), buf.size(), 0);
+ *   });
+ * awaiter作为co_await的临时对象保存在协程帧中，SqeData也在其中，没有堆分配；
+ * 每个操作的开销固定为sizeof(SqeData) + sizeof(Prep)。
+ * 多个操作可以用io_batch一次提交，全部完成后恢复。
+ */
+
+namespace yjcServer {
+
+/// @brief 单个io_uring操作的awaiter
+/// @tparam Prep void(io_uring_sqe*)，在await_suspend中调用一次
+template <class Prep>
+class [[nodiscard]] io_awaiter {
+private:
+    Prep    m_prep;
+    SqeData m_data;
+
+public:
+    explicit io_awaiter(Prep prep) : m_prep(std::move(prep)) {}
+
+    bool await_ready() const noexcept {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        io_uring_sqe* sqe = IOUring::Instance().get_sqe();
+        m_prep(sqe);
+        m_data.handle = handle.address();
+        io_uring_sqe_set_data(sqe, &m_data);
+    }
+
+    /// @return cqe的res，失败时为-errno
+    int await_resume() const noexcept {
+        return m_data.cqe_res;
+    }
+};
+
+/// @brief 多个操作一次提交，全部完成后恢复，返回各自的cqe res
+template <class... Preps>
+class [[nodiscard]] io_batch_awaiter {
+private:
+    static constexpr size_t N = sizeof...(Preps);
+
+    struct op_data : SqeData {
+        io_batch_awaiter* batch = nullptr;
+    };
+
+    std::tuple<Preps...>    m_preps;
+    std::array<op_data, N>  m_ops;
+    size_t                  m_remaining = N;
+    std::coroutine_handle<> m_handle;
+
+    static void on_cqe(SqeData* data) {
+        io_batch_awaiter* batch = static_cast<op_data*>(data)->batch;
+        if (--batch->m_remaining == 0) {
+            batch->m_handle.resume();
+        }
+    }
+
+    template <size_t I>
+    void submit_one() {
+        io_uring_sqe* sqe = IOUring::Instance().get_sqe();
+        std::get<I>(m_preps)(sqe);
+        m_ops[I].batch = this;
+        m_ops[I].on_cqe = &io_batch_awaiter::on_cqe;
+        io_uring_sqe_set_data(sqe, &m_ops[I]);
+    }
+
+public:
+    explicit io_batch_awaiter(Preps... preps) : m_preps(std::move(preps)...) {}
+
+    bool await_ready() const noexcept {
+        return N == 0;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) {
+        m_handle = handle;
+        m_remaining = N;
+        [this]<size_t... I>(std::index_sequence<I...>) {
+            (submit_one<I>(), ...);
+        }(std::make_index_sequence<N>{});
+    }
+
+    std::array<int, N> await_resume() const noexcept {
+        std::array<int, N> res;
+        for (size_t i = 0; i < N; ++i) {
+            res[i] = m_ops[i].cqe_res;
+        }
+        return res;
+    }
+};
+
+/// @brief 用prep构造单个操作的awaiter
+template <class Prep>
+io_awaiter<Prep> io_op(Prep prep) {
+    return io_awaiter<Prep>(std::move(prep));
+}
+
+/// @brief co_await io_batch(prep1, prep2, ...) -> std::array<int, N>
+template <class... Preps>
+io_batch_awaiter<Preps...> io_batch(Preps... preps) {
+    return io_batch_awaiter<Preps...>(std::move(preps)...);
+}
+
+//---------------------------常用操作---------------------------------
+// 参数引用的缓冲区/地址需要在co_await完成前保持有效
+
+inline auto async_read(int fd, std::span<char> buf, uint64_t offset = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_read(sqe, fd, buf.data(), buf.size(), offset);
+    });
+}
+
+inline auto async_write(int fd, std::span<const char> buf,
+                        uint64_t offset = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_write(sqe, fd, buf.data(), buf.size(), offset);
+    });
+}
+
+inline auto async_recv(int fd, std::span<char> buf, int flags = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_recv(sqe, fd, buf.data(), buf.size(), flags);
+    });
+}
+
+inline auto async_send(int fd, std::span<const char> buf, int flags = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_send(sqe, fd, buf.data(), buf.size(), flags);
+    });
+}
+
+inline auto async_accept(int fd, sockaddr* addr = nullptr,
+                         socklen_t* addr_len = nullptr, int flags = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_accept(sqe, fd, addr, addr_len, flags);
+    });
+}
+
+inline auto async_connect(int fd, const sockaddr* addr, socklen_t addr_len) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_connect(sqe, fd, addr, addr_len);
+    });
+}
+
+inline auto async_close(int fd) {
+    return io_op([=](io_uring_sqe* sqe) { io_uring_prep_close(sqe, fd); });
+}
+
+inline auto async_splice(int fd_in, int64_t off_in, int fd_out,
+                         int64_t off_out, unsigned int nbytes,
+                         unsigned int flags = 0) {
+    return io_op([=](io_uring_sqe* sqe) {
+        io_uring_prep_splice(sqe, fd_in, off_in, fd_out, off_out, nbytes,
+                             flags);
+    });
+}
+
+/// @brief 定时器，超时完成时res为-ETIME
+/// timespec保存在prep对象中，随awaiter一起留在协程帧里
+inline auto async_timeout(__kernel_timespec ts) {
+    return io_op([ts](io_uring_sqe* sqe) mutable {
+        io_uring_prep_timeout(sqe, &ts, 0, 0);
+    });
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,120 @@
+#pragma once
+#include <openssl/ssl.h>
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string>
+
+/*
+ * kTLS卸载
+ * 只有握手在用户态(OpenSSL)完成，握手结束后把TLS 1.3的流量密钥通过
+ * setsockopt(SOL_TLS)交给内核，之后该socket上的recv/send/splice/sendfile
+ * 都直接收发明文，加解密由内核完成，io_uring的零拷贝路径不受影响。
+ *
+ * 握手过程不直接读写socket，而是由调用者通过io_uring收发:
+ *   while (true) {
+ *       switch (hs.advance()) {
+ *       case ktls_handshake::status::want_write: 发送hs.output()，hs.consume_output(n)
+ *       case ktls_handshake::status::want_read: 接收到hs.input()，hs.commit_input(n)
+ *       case ktls_handshake::status::done: hs.install(fd)
+ *       case ktls_handshake::status::error: 关闭连接
+ *       }
+ *   }
+ * 读取按TLS记录边界进行，握手结束时客户端后续的数据仍留在socket里交给内核解密。
+ */
+
+namespace yjcServer {
+
+/// @brief 服务端TLS上下文(证书/私钥)，所有连接共享
+class tls_context {
+private:
+    SSL_CTX* m_ctx = nullptr;
+
+public:
+    /// @brief 加载证书链和私钥，失败抛出std::runtime_error
+    tls_context(const std::string& cert_file, const std::string& key_file);
+    ~tls_context();
+
+    tls_context(const tls_context&) = delete;
+    tls_context& operator=(const tls_context&) = delete;
+
+    SSL_CTX* get() const {
+        return m_ctx;
+    }
+};
+
+/// @brief 单个连接的用户态握手，完成后安装内核TLS
+class ktls_handshake {
+    friend class tls_context;
+
+public:
+    enum class status : uint8_t { want_read, want_write, done, error };
+
+    //记录头5字节 + 最大密文长度(2^14 + 256)
+    static constexpr size_t record_header_size = 5;
+    static constexpr size_t max_record_size =
+        record_header_size + 16384 + 256;
+
+private:
+    SSL* m_ssl = nullptr;
+    BIO* m_rbio = nullptr;  //由SSL持有
+    BIO* m_wbio = nullptr;  //由SSL持有
+
+    //当前正在读取的记录
+    std::array<char, max_record_size> m_record;
+    size_t                            m_record_len = 0;
+    size_t                            m_record_need = record_header_size;
+    //等待发送的握手数据
+    std::array<char, 16384> m_output;
+    size_t                  m_output_begin = 0;
+    size_t                  m_output_end = 0;
+
+    //由keylog回调写入的应用流量密钥
+    std::array<unsigned char, 48> m_client_secret{};
+    std::array<unsigned char, 48> m_server_secret{};
+    size_t                        m_secret_len = 0;
+    bool                          m_has_client_secret = false;
+    bool                          m_has_server_secret = false;
+
+    static void keylog_callback(const SSL* ssl, const char* line);
+    void        on_keylog(const char* line);
+
+public:
+    explicit ktls_handshake(tls_context& ctx);
+    ~ktls_handshake();
+
+    ktls_handshake(const ktls_handshake&) = delete;
+    ktls_handshake& operator=(const ktls_handshake&) = delete;
+
+    /// @brief 推进握手，返回调用者接下来需要做的事
+    status advance();
+
+    /// @brief 需要从socket读取的缓冲区，大小恰好为当前记录剩余的字节数
+    std::span<char> input() {
+        return {m_record.data() + m_record_len, m_record_need - m_record_len};
+    }
+
+    /// @brief 提交读取到input()中的n个字节
+    /// @return 记录头非法返回false
+    bool commit_input(size_t n);
+
+    /// @brief 需要写入socket的数据
+    std::span<const char> output() const {
+        return {m_output.data() + m_output_begin,
+                m_output_end - m_output_begin};
+    }
+
+    void consume_output(size_t n) {
+        m_output_begin += n;
+    }
+
+    /// @brief 握手完成后安装TX/RX密钥到内核
+    /// @return 失败(内核不支持tls ULP、非TLS1.3或不支持的套件)返回false，
+    /// 此时连接已不可用，应当关闭
+    bool install(int fd);
+
+    /// @brief 协商出的密码套件名称
+    const char* cipher_name() const;
+};
+
+}  // namespace yjcServer
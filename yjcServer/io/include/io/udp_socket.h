@@ -0,0 +1,195 @@
+#pragma once
+#include <io/IOUring.h>
+#include <io/file_descriptor.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <array>
+#include <coroutine>
+#include <optional>
+#include <span>
+#include <string>
+
+/*
+ * UDP数据报服务
+ *   ·接收: 一个multishot recvmsg从buf_ring取缓冲区，每个cqe对应一个数据报，
+ *     缓冲区内是io_uring_recvmsg_out头 + 对端地址 + 负载
+ *   ·发送: udp_send_batch把多条回复用hardlink串起来一次提交，GSO可用时同一
+ *     对端的等长分段合并为一个sendmsg
+ * 与IOUring/Buffer_ring一样是线程单例语义，只能在创建它的线程上使用。
+ */
+
+namespace yjcServer {
+
+/// @brief 收到的一个数据报，payload和peer都指向借用的provided buffer，
+/// 处理完后需要udp_recv_stream::release归还
+struct udp_datagram {
+    const sockaddr* peer = nullptr;
+    socklen_t       peer_len = 0;
+    std::span<char> payload;
+    bool            truncated = false;  //负载超过缓冲区被截断
+    unsigned int    buf_id = 0;
+};
+
+class udp_socket {
+private:
+    file_descriptor m_fd;
+    bool            m_gso = false;
+
+    explicit udp_socket(file_descriptor fd) : m_fd(std::move(fd)) {}
+
+public:
+    /// @brief 创建并绑定UDP socket
+    /// @return 失败时记录日志并返回空
+    static std::optional<udp_socket> bind(const std::string& ip,
+                                          uint16_t           port);
+
+    int get_raw_fd() const {
+        return m_fd.get_raw_fd();
+    }
+
+    /// @brief 探测并开启UDP GSO(UDP_SEGMENT)
+    /// @return 内核不支持返回false
+    bool enable_gso();
+
+    bool gso_enabled() const {
+        return m_gso;
+    }
+};
+
+/// @brief multishot recvmsg接收流
+/// 结束前必须stop()并co_await next()直到返回空，保证内核不再引用该对象
+class udp_recv_stream {
+public:
+    static constexpr size_t max_pending = 256;  //未被消费的数据报上限
+
+private:
+    struct stream_sqe : SqeData {
+        udp_recv_stream* stream = nullptr;
+    };
+
+    int        m_fd;
+    msghdr     m_msg{};  //只用于告诉内核name/control的长度
+    stream_sqe m_sqe;
+
+    std::array<udp_datagram, max_pending> m_pending;
+    size_t                                m_head = 0;
+    size_t                                m_count = 0;
+
+    std::coroutine_handle<> m_waiter;
+    bool                    m_armed = false;
+    bool                    m_stopped = false;
+    uint64_t                m_dropped = 0;
+
+    static void on_cqe(SqeData* data);
+    void        arm();
+    void        push(int res, unsigned int flags);
+
+public:
+    explicit udp_recv_stream(udp_socket& socket);
+    ~udp_recv_stream();
+
+    udp_recv_stream(const udp_recv_stream&) = delete;
+    udp_recv_stream& operator=(const udp_recv_stream&) = delete;
+
+    struct next_awaiter {
+        udp_recv_stream& stream;
+
+        bool await_ready() const noexcept {
+            return stream.m_count > 0 || (stream.m_stopped && !stream.m_armed);
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        /// @return 下一个数据报，流已结束返回空
+        std::optional<udp_datagram> await_resume();
+    };
+
+    /// @brief co_await stream.next()获取下一个数据报
+    next_awaiter next() {
+        return {*this};
+    }
+
+    /// @brief 归还数据报占用的缓冲区
+    void release(const udp_datagram& datagram);
+
+    /// @brief 取消multishot，之后next()在排空已收到的数据报后返回空
+    void stop();
+
+    /// @brief 因排队已满或格式错误被丢弃的数据报数
+    uint64_t dropped() const {
+        return m_dropped;
+    }
+};
+
+/// @brief 批量发送，co_await send()一次提交所有消息
+/// 负载在send()完成前需要保持有效
+class udp_send_batch {
+public:
+    static constexpr size_t max_messages = 64;
+    static constexpr size_t max_gso_segments = 64;  //内核UDP_MAX_SEGMENTS
+    static constexpr size_t max_gso_bytes = 65000;
+
+private:
+    struct entry {
+        msghdr       msg;
+        iovec        iov;
+        sockaddr_in6 peer;  //能放下sockaddr_in/sockaddr_in6
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))];
+    };
+    struct batch_sqe : SqeData {
+        udp_send_batch* batch = nullptr;
+    };
+
+    int                             m_fd;
+    bool                            m_gso;
+    std::array<entry, max_messages> m_entries;
+    size_t                          m_size = 0;
+    size_t                          m_remaining = 0;
+    size_t                          m_failed = 0;
+    batch_sqe                       m_sqe;
+    std::coroutine_handle<>         m_waiter;
+
+    static void on_cqe(SqeData* data);
+    entry*      add_entry(const sockaddr* peer, socklen_t peer_len,
+                          std::span<const char> payload);
+
+public:
+    explicit udp_send_batch(udp_socket& socket);
+
+    udp_send_batch(const udp_send_batch&) = delete;
+    udp_send_batch& operator=(const udp_send_batch&) = delete;
+
+    /// @brief 添加一条消息，批次已满返回false
+    bool add(const sockaddr* peer, socklen_t peer_len,
+             std::span<const char> payload);
+
+    /// GSO开启时合并为尽量少的sendmsg，否则(或一段超过max_gso_bytes)逐个添加
+    /// GSO开启时合并为尽量少的sendmsg；不支持GSO或一段超过max_gso_bytes时逐个添加
+    /// @return 批次放不下时返回false(已添加的部分保留)
+    bool add_segments(const sockaddr* peer, socklen_t peer_len,
+                      std::span<const char> data, uint16_t segment_size);
+
+    size_t size() const {
+        return m_size;
+    }
+
+    void clear() {
+        m_size = 0;
+    }
+
+    struct send_awaiter {
+        udp_send_batch& batch;
+
+        bool await_ready() const noexcept {
+            return batch.m_size == 0;
+        }
+        void await_suspend(std::coroutine_handle<> handle);
+        /// @return 发送失败的sendmsg个数
+        size_t await_resume();
+    };
+
+    /// @brief 用hardlink串联所有sendmsg一次提交，全部完成后恢复
+    send_awaiter send() {
+        return {*this};
+    }
+};
+
+}  // namespace yjcServer
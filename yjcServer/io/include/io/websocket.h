@@ -0,0 +1,228 @@
+#pragma once
+#include <liburing.h>
+#include <sys/uio.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+
+/*
+ * websocket帧处理(RFC 6455)
+ * 设计目标是配合multishot recv + buf_ring使用:
+ *   ·帧头直接在内核提供的缓冲区上解析，不拷贝
+ *   ·完整落在一个缓冲区内的未分片帧，原地SIMD去掩码后直接交给上层
+ *   ·只有分片消息/跨缓冲区的帧才拷贝进连接级的ws_arena重组
+ *   ·出站帧通过ws_writer聚合为一次writev
+ * 稳态下解析过程不做任何堆分配。
+ */
+
+namespace yjcServer {
+
+/// @brief websocket帧操作码
+enum class ws_opcode : uint8_t {
+    continuation = 0x0,
+    text = 0x1,
+    binary = 0x2,
+    close = 0x8,
+    ping = 0x9,
+    pong = 0xA,
+};
+
+/// @brief 帧头
+struct ws_frame_header {
+    bool                   fin = false;
+    ws_opcode              opcode = ws_opcode::continuation;
+    bool                   masked = false;
+    std::array<uint8_t, 4> mask_key{};
+    uint64_t               payload_len = 0;
+    size_t                 header_len = 0;  //帧头总长度(2~14)
+};
+
+enum class ws_parse_status : uint8_t { ok, incomplete, error };
+
+/// @brief 从data起始处解析帧头，不拷贝数据
+/// @return incomplete表示数据不足以解析出完整帧头
+ws_parse_status ws_parse_frame_header(std::span<const char> data,
+                                      ws_frame_header&      header);
+
+/// @brief 使用mask_key对payload原地异或(SIMD)
+/// @param offset payload在整个帧负载中的偏移，用于跨缓冲区续接掩码
+void ws_unmask(std::span<char> payload, std::array<uint8_t, 4> mask_key,
+               uint64_t offset = 0);
+
+//-------------------------------握手---------------------------------
+
+/// @brief 检查HTTP请求是否为websocket升级请求
+/// @param request 完整的请求头(到\r\n\r\n为止)
+/// @return Sec-WebSocket-Key的值，不是合法的升级请求返回空
+std::string_view ws_upgrade_key(std::string_view request);
+
+/// @brief 将101 Switching Protocols响应写入out
+/// @return 写入的字节数，out空间不足或key非法返回0
+size_t ws_write_handshake_response(std::string_view key, std::span<char> out);
+
+//-----------------------------消息重组区------------------------------
+
+/// @brief 连接级的分片消息重组区
+/// 第一次需要时才分配内存，之后清空复用；空闲连接可调用release归还内存
+class ws_arena {
+private:
+    std::unique_ptr<char[]> m_data;
+    size_t                  m_size = 0;
+    size_t                  m_capacity = 0;
+    size_t                  m_limit;  //单条消息最大长度
+
+public:
+    explicit ws_arena(size_t limit) : m_limit(limit) {}
+
+    /// @brief 追加数据，超过m_limit返回false
+    bool append(std::span<const char> data);
+
+    std::span<char> data() {
+        return {m_data.get(), m_size};
+    }
+
+    size_t size() const {
+        return m_size;
+    }
+
+    size_t limit() const {
+        return m_limit;
+    }
+
+    /// @brief 清空数据，保留内存
+    void clear() {
+        m_size = 0;
+    }
+
+    /// @brief 归还内存
+    void release() {
+        m_data.reset();
+        m_size = 0;
+        m_capacity = 0;
+    }
+};
+
+//------------------------------入站解析-------------------------------
+
+/// @brief 单个连接的入站帧状态机(服务端，要求客户端帧带掩码)
+class ws_connection {
+public:
+    static constexpr size_t max_control_payload = 125;
+
+    enum class step_status : uint8_t { message, need_more, error };
+
+    /// @brief 一条完整的消息，payload指向provided buffer或ws_arena，
+    /// 只在下一次step/feed之前有效
+    struct message {
+        ws_opcode       opcode = ws_opcode::continuation;
+        std::span<char> payload;
+    };
+
+private:
+    ws_arena m_arena;
+    //跨缓冲区的帧头
+    std::array<char, 14> m_header_stash{};
+    size_t               m_header_stash_len = 0;
+    //控制帧可能跨缓冲区，且允许穿插在分片消息之间，单独存放
+    std::array<char, max_control_payload> m_control{};
+    size_t                                m_control_len = 0;
+
+    ws_frame_header m_header;
+    bool            m_in_frame = false;
+    uint64_t        m_frame_offset = 0;  //当前帧已处理的负载字节数
+    bool            m_fragmented = false;
+    ws_opcode       m_message_opcode = ws_opcode::continuation;
+
+    /// @brief 解析并校验帧头，消耗data中属于帧头的部分
+    step_status read_header(std::span<char>& data);
+
+public:
+    /// @param max_message_size 单条消息(含所有分片)的最大长度
+    explicit ws_connection(size_t max_message_size = 16 * 1024 * 1024)
+        : m_arena(max_message_size) {}
+
+    /// @brief 从data中消费字节直到得到一条消息或数据耗尽
+    /// @param data 输入，返回时指向未消费的部分
+    /// @param out step_status::message时有效
+    step_status step(std::span<char>& data, message& out);
+
+    /// @brief 处理一块缓冲区，每得到一条完整消息调用一次on_message(const
+    /// message&)
+    /// @return false表示协议错误，应发送close并关闭连接
+    template <class F>
+    bool feed(std::span<char> data, F&& on_message) {
+        message msg;
+        while (true) {
+            switch (step(data, msg)) {
+            case step_status::message:
+                on_message(msg);
+                break;
+            case step_status::need_more:
+                return true;
+            default:
+                return false;
+            }
+        }
+    }
+
+    /// @brief 连接空闲时归还重组区内存
+    /// 只在帧边界上归还: 跨缓冲区的未分片帧也在重组区里拼接，帧头可能还在暂存
+    void shrink() {
+        if (!m_in_frame && !m_fragmented && m_header_stash_len == 0) {
+            m_arena.release();
+        }
+    }
+};
+
+//------------------------------出站聚合-------------------------------
+
+/// @brief 出站帧聚合器，多帧的帧头和负载组成iovec数组，一次writev发出
+/// payload在写完之前需要保持有效
+class ws_writer {
+public:
+    static constexpr size_t max_frames = 32;
+
+private:
+    std::array<std::array<char, 10>, max_frames> m_headers;
+    std::array<iovec, max_frames * 2>            m_iovs;
+    size_t                                       m_frames = 0;
+    size_t                                       m_iov_begin = 0;
+    size_t                                       m_iov_end = 0;
+
+public:
+    ws_writer() = default;
+    // iovec指向自身的m_headers，禁止拷贝/移动
+    ws_writer(const ws_writer&) = delete;
+    ws_writer& operator=(const ws_writer&) = delete;
+
+    /// @brief 追加一帧(服务端帧不带掩码)
+    /// @return 已满返回false，需要先flush
+    bool add_frame(ws_opcode opcode, std::span<const char> payload,
+                   bool fin = true);
+
+    bool empty() const {
+        return m_iov_begin == m_iov_end;
+    }
+
+    std::span<const iovec> iovecs() const {
+        return {m_iovs.data() + m_iov_begin, m_iov_end - m_iov_begin};
+    }
+
+    /// @brief 根据writev的返回值推进，处理部分写
+    /// @return 全部写完返回true
+    bool consume(size_t written);
+
+    void clear() {
+        m_frames = 0;
+        m_iov_begin = 0;
+        m_iov_end = 0;
+    }
+
+    /// @brief 用剩余的iovec准备一个writev sqe
+    void prep_writev(io_uring_sqe* sqe, int fd) const;
+};
+
+}  // namespace yjcServer
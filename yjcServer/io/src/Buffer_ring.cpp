@@ -24,7 +24,8 @@ void Buffer_ring::register_buf_ring(const unsigned int buf_ring_size,
         m_buf_list.emplace_back(buf_size);
     }
 
-    IOUring::Instance().setup_buf_ring(m_buf_ring.get(), m_buf_list, buf_size);
+    IOUring::Instance().setup_buf_ring(m_buf_ring.get(), m_buf_list,
+                                      buf_ring_size);
 }
 
 std::span<char> Buffer_ring::borrow_buf(const unsigned int buf_id,
@@ -1,18 +1,22 @@
 #include <Config/util.h>
+#include <io/Buffer_ring.h>
 #include <io/IOUring.h>
+#include <io/admission.h>
+#include <thread/Thread.h>
+#include <coroutine>
 
 #define IO_URING_QUEUE_SIZE 2048  // TODO:配置
-#define BUFFER_GROUP_ID 0
+#define CQE_BATCH_SIZE 64         //每次从完成队列取出的cqe数量
 
 namespace yjcServer {
 
 IOUring::IOUring() {
-    int res = io_uring_queue_init(IO_URING_QUEUE_SIZE, m_ring, 0);
+    int res = io_uring_queue_init(IO_URING_QUEUE_SIZE, &m_ring, 0);
     YJC_ASSERT(res == 0);
 }
 
 IOUring::~IOUring() {
-    io_uring_queue_exit(m_ring);
+    io_uring_queue_exit(&m_ring);
 }
 
 IOUring& IOUring::Instance() {
@@ -20,8 +24,81 @@ IOUring& IOUring::Instance() {
     return ring;
 }
 
-io_uring* IOUring::get() const {
-    return m_ring;
+//线程池预热时预先创建工作线程的io_uring和缓冲区环，不在第一个请求上付出这部分开销
+static const bool warmup_registered = [] {
+    Thread::AddWarmup([] {
+        IOUring::Instance();
+        Buffer_ring::Instance();
+    });
+    return true;
+}();
+
+io_uring* IOUring::get() {
+    return &m_ring;
+}
+
+io_uring_sqe* IOUring::get_sqe() {
+    io_uring_sqe* sqe = io_uring_get_sqe(&m_ring);
+    if (sqe == nullptr) [[unlikely]] {
+        io_uring_submit(&m_ring);
+        sqe = io_uring_get_sqe(&m_ring);
+    }
+    YJC_ASSERT(sqe != nullptr);
+    return sqe;
+}
+
+int IOUring::submit() {
+    return io_uring_submit(&m_ring);
+}
+
+unsigned IOUring::run_once(bool wait) {
+    Admission& admission = Admission::Instance();
+    if (wait && admission.has_waiters()) {
+        //准入阈值可能在运行时放宽，不能无限期阻塞，否则挂起的等待者要等到下一个事件
+        __kernel_timespec ts{.tv_sec = 0,
+                             .tv_nsec = ADMISSION_TICK_MS * 1000000LL};
+        io_uring_cqe* cqe;
+        io_uring_submit(&m_ring);
+        io_uring_wait_cqe_timeout(&m_ring, &cqe, &ts);
+    } else if (wait) {
+        io_uring_submit_and_wait(&m_ring, 1);
+    } else {
+        io_uring_submit(&m_ring);
+    }
+
+    //先把结果拷出并推进完成队列，恢复协程时可能会继续提交sqe
+    io_uring_cqe* cqes[CQE_BATCH_SIZE];
+    SqeData*      datas[CQE_BATCH_SIZE];
+    int           res[CQE_BATCH_SIZE];
+    unsigned      flags[CQE_BATCH_SIZE];
+    unsigned      total = 0;
+    unsigned      count;
+    do {
+        count = io_uring_peek_batch_cqe(&m_ring, cqes, CQE_BATCH_SIZE);
+        for (unsigned i = 0; i < count; ++i) {
+            datas[i] = static_cast<SqeData*>(io_uring_cqe_get_data(cqes[i]));
+            res[i] = cqes[i]->res;
+            flags[i] = cqes[i]->flags;
+        }
+        io_uring_cq_advance(&m_ring, count);
+
+        for (unsigned i = 0; i < count; ++i) {
+            SqeData* data = datas[i];
+            if (data == nullptr) {
+                continue;
+            }
+            data->cqe_res = res[i];
+            data->cqe_flag = flags[i];
+            if (data->on_cqe) {
+                data->on_cqe(data);
+            } else if (data->handle) {
+                std::coroutine_handle<>::from_address(data->handle).resume();
+            }
+        }
+        total += count;
+    } while (count == CQE_BATCH_SIZE);
+    admission.poll();
+    return total;
 }
 
 //-----------------------buf_ring-------------------------
@@ -33,7 +110,7 @@ void IOUring::setup_buf_ring(io_uring_buf_ring*           buf_ring,
                          .ring_entries = buf_ring_size,
                          .bgid = BUFFER_GROUP_ID};
     //将buf_ring注册到内核中
-    const int result = io_uring_register_buf_ring(m_ring, &reg, 0);
+    const int result = io_uring_register_buf_ring(&m_ring, &reg, 0);
     YJC_ASSERT(result == 0);
 
     //初始化环上的每个buffer
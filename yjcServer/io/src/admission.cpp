@@ -0,0 +1,287 @@
+#include <Config/Config.h>
+#include <io/admission.h>
+#include <algorithm>
+#include <atomic>
+#include <string_view>
+#include <utility>
+
+namespace yjcServer {
+
+/// @brief 准入控制的配置结构
+struct AdmissionConfig {
+    size_t max_connections = 0;
+    size_t max_inflight_requests = 0;
+    size_t max_borrowed_buffers = 0;
+    //超过上限时，借用数至少达到这个值的连接才会被暂停
+    size_t noisy_connection_buffers = 8;
+    //低水位百分比，回落到上限*resume_percent/100以下才恢复
+    size_t resume_percent = 90;
+
+    bool operator==(const AdmissionConfig& other) const {
+        return max_connections == other.max_connections &&
+               max_inflight_requests == other.max_inflight_requests &&
+               max_borrowed_buffers == other.max_borrowed_buffers &&
+               noisy_connection_buffers == other.noisy_connection_buffers &&
+               resume_percent == other.resume_percent;
+    }
+};
+
+/// @brief fromYaml(AdmissionConfig)
+template <>
+class LexicalCast<YAML::Node, AdmissionConfig> {
+public:
+    AdmissionConfig operator()(const YAML::Node& node) {
+        AdmissionConfig res;
+        if (node["max_connections"].IsDefined()) {
+            res.max_connections = node["max_connections"].as<size_t>();
+        }
+        if (node["max_inflight_requests"].IsDefined()) {
+            res.max_inflight_requests =
+                node["max_inflight_requests"].as<size_t>();
+        }
+        if (node["max_borrowed_buffers"].IsDefined()) {
+            res.max_borrowed_buffers =
+                node["max_borrowed_buffers"].as<size_t>();
+        }
+        if (node["noisy_connection_buffers"].IsDefined()) {
+            res.noisy_connection_buffers =
+                node["noisy_connection_buffers"].as<size_t>();
+        }
+        if (node["resume_percent"].IsDefined()) {
+            res.resume_percent = node["resume_percent"].as<size_t>();
+        }
+        return res;
+    }
+};
+
+/// @brief fromString(AdmissionConfig)
+template <>
+class LexicalCast<std::string, AdmissionConfig> {
+public:
+    AdmissionConfig operator()(const std::string& v) {
+        return LexicalCast<YAML::Node, AdmissionConfig>()(YAML::Load(v));
+    }
+};
+
+/// @brief toString(AdmissionConfig)
+template <>
+class LexicalCast<AdmissionConfig, std::string> {
+public:
+    std::string operator()(const AdmissionConfig& v) {
+        YAML::Node node;
+        node["max_connections"] = v.max_connections;
+        node["max_inflight_requests"] = v.max_inflight_requests;
+        node["max_borrowed_buffers"] = v.max_borrowed_buffers;
+        node["noisy_connection_buffers"] = v.noisy_connection_buffers;
+        node["resume_percent"] = v.resume_percent;
+        std::stringstream ss;
+        ss << node;
+        return ss.str();
+    }
+};
+
+namespace {
+
+/// @brief 所有reactor共享的阈值，配置变更时由回调更新
+struct AdmissionLimits {
+    std::atomic<size_t>   max_connections{0};
+    std::atomic<size_t>   max_inflight_requests{0};
+    std::atomic<size_t>   max_borrowed_buffers{0};
+    std::atomic<size_t>   noisy_connection_buffers{8};
+    std::atomic<size_t>   resume_percent{90};
+    std::atomic<uint64_t> generation{0};  //每次apply加一，reactor据此发现阈值变化
+
+    void apply(const AdmissionConfig& config) {
+        max_connections.store(config.max_connections,
+                              std::memory_order_relaxed);
+        max_inflight_requests.store(config.max_inflight_requests,
+                                    std::memory_order_relaxed);
+        max_borrowed_buffers.store(config.max_borrowed_buffers,
+                                   std::memory_order_relaxed);
+        noisy_connection_buffers.store(config.noisy_connection_buffers,
+                                       std::memory_order_relaxed);
+        resume_percent.store(std::min<size_t>(config.resume_percent, 100),
+                             std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    /// @brief 上限对应的低水位
+    size_t low_watermark(size_t max) const {
+        return max * resume_percent.load(std::memory_order_relaxed) / 100;
+    }
+};
+
+AdmissionLimits& GetLimits() {
+    static AdmissionLimits s_limits;
+    return s_limits;
+}
+
+}  // namespace
+
+/*
+ *---------------------------------全局对象--------------------------------------
+ */
+static auto admission_configs = Config::Lookup<AdmissionConfig>(
+    "admission", {}, "admission_configs");
+[[maybe_unused]] static auto admission_listener =
+    admission_configs->addListener([](const AdmissionConfig&,
+                                      const AdmissionConfig& new_value) {
+        GetLimits().apply(new_value);
+    });
+
+//------------------------------Admission------------------------------
+
+Admission& Admission::Instance() {
+    thread_local Admission instance;
+    return instance;
+}
+
+bool Admission::can_accept() const {
+    const size_t max =
+        GetLimits().max_connections.load(std::memory_order_relaxed);
+    return max == 0 || m_connections < max;
+}
+
+bool Admission::add_connection() {
+    if (!can_accept()) {
+        return false;
+    }
+    ++m_connections;
+    return true;
+}
+
+void Admission::remove_connection() {
+    --m_connections;
+    maybe_resume_accept();
+}
+
+void Admission::poll() {
+    const uint64_t generation =
+        GetLimits().generation.load(std::memory_order_acquire);
+    if (generation == m_generation) {
+        return;
+    }
+    m_generation = generation;
+    //上限调高或取消后，挂起的accept循环和暂停的连接不必等到有连接关闭
+    maybe_resume_accept();
+    maybe_resume_recv();
+}
+
+void Admission::maybe_resume_accept() {
+    if (!m_accept_waiter) {
+        return;
+    }
+    const AdmissionLimits& limits = GetLimits();
+    const size_t max = limits.max_connections.load(std::memory_order_relaxed);
+    if (max == 0 || m_connections <= limits.low_watermark(max)) {
+        std::exchange(m_accept_waiter, nullptr).resume();
+    }
+}
+
+bool Admission::try_begin_request() {
+    const size_t max =
+        GetLimits().max_inflight_requests.load(std::memory_order_relaxed);
+    if (max && m_inflight >= max) {
+        return false;
+    }
+    ++m_inflight;
+    return true;
+}
+
+void Admission::end_request() {
+    --m_inflight;
+}
+
+std::span<const char> Admission::reject_response() {
+    static constexpr std::string_view response =
+        "HTTP/1.1 503 Service Unavailable\r\n"
+        "Content-Length: 0\r\n"
+        "Retry-After: 1\r\n"
+        "Connection: close\r\n"
+        "\r\n";
+    return response;
+}
+
+bool Admission::borrow(admission_conn& conn) {
+    ++conn.m_borrowed;
+    ++m_borrowed;
+    const AdmissionLimits& limits = GetLimits();
+    const size_t max =
+        limits.max_borrowed_buffers.load(std::memory_order_relaxed);
+    if (max == 0 || m_borrowed < max) {
+        return false;
+    }
+    //超限时只暂停占用超过公平份额的连接
+    const size_t noisy =
+        limits.noisy_connection_buffers.load(std::memory_order_relaxed);
+    const size_t fair =
+        std::max(noisy, m_borrowed / std::max<size_t>(m_connections, 1));
+    return conn.m_borrowed >= fair;
+}
+
+void Admission::giveback(admission_conn& conn) {
+    --conn.m_borrowed;
+    --m_borrowed;
+    maybe_resume_recv();
+}
+
+void Admission::detach(admission_conn& conn) {
+    m_borrowed -= conn.m_borrowed;
+    conn.m_borrowed = 0;
+    if (conn.m_paused) {
+        admission_conn* prev = nullptr;
+        for (admission_conn* it = m_paused_head; it; it = it->m_next) {
+            if (it == &conn) {
+                (prev ? prev->m_next : m_paused_head) = it->m_next;
+                if (m_paused_tail == it) {
+                    m_paused_tail = prev;
+                }
+                break;
+            }
+            prev = it;
+        }
+        conn.m_next = nullptr;
+        conn.m_paused = false;
+        conn.m_waiter = nullptr;
+    }
+    maybe_resume_recv();
+}
+
+void Admission::maybe_resume_recv() {
+    const AdmissionLimits& limits = GetLimits();
+    while (m_paused_head) {
+        const size_t max =
+            limits.max_borrowed_buffers.load(std::memory_order_relaxed);
+        if (max && m_borrowed > limits.low_watermark(max)) {
+            return;
+        }
+        admission_conn* conn = m_paused_head;
+        m_paused_head = conn->m_next;
+        if (m_paused_head == nullptr) {
+            m_paused_tail = nullptr;
+        }
+        conn->m_next = nullptr;
+        conn->m_paused = false;
+        std::exchange(conn->m_waiter, nullptr).resume();
+    }
+}
+
+bool Admission::recv_awaiter::await_ready() const {
+    const size_t max =
+        GetLimits().max_borrowed_buffers.load(std::memory_order_relaxed);
+    return max == 0 || admission.m_borrowed < max;
+}
+
+void Admission::recv_awaiter::await_suspend(std::coroutine_handle<> handle) {
+    conn.m_waiter = handle;
+    conn.m_paused = true;
+    conn.m_next = nullptr;
+    if (admission.m_paused_tail) {
+        admission.m_paused_tail->m_next = &conn;
+    } else {
+        admission.m_paused_head = &conn;
+    }
+    admission.m_paused_tail = &conn;
+}
+
+}  // namespace yjcServer
@@ -1,4 +1,5 @@
 #include <io/file_descriptor.h>
+#include <unistd.h>
 #include <utility>
 
 namespace yjcServer {
@@ -21,6 +22,9 @@ file_descriptor& file_descriptor::operator=(file_descriptor&& other) {
     if (this == std::addressof(other)) {
         return *this;
     }
+    if (m_raw_fd.has_value()) {
+        close(m_raw_fd.value());
+    }
     m_raw_fd = std::exchange(other.m_raw_fd, std::nullopt);
     return *this;
 }
@@ -0,0 +1,308 @@
+#include <io/ktls.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/core_names.h>
+#include <openssl/err.h>
+#include <openssl/kdf.h>
+#include <spdlog/spdlog.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+
+namespace yjcServer {
+
+namespace {
+
+std::string openssl_error() {
+    char buf[256];
+    ERR_error_string_n(ERR_get_error(), buf, sizeof(buf));
+    return buf;
+}
+
+/// @brief TLS 1.3 HKDF-Expand-Label(secret, label, "", out.size())
+bool hkdf_expand_label(const char* digest, std::span<const unsigned char> secret,
+                       std::string_view label, std::span<unsigned char> out) {
+    static constexpr std::string_view prefix = "tls13 ";
+    unsigned char                     info[2 + 1 + 255 + 1];
+    size_t                            n = 0;
+    info[n++] = static_cast<unsigned char>(out.size() >> 8);
+    info[n++] = static_cast<unsigned char>(out.size());
+    info[n++] = static_cast<unsigned char>(prefix.size() + label.size());
+    std::memcpy(info + n, prefix.data(), prefix.size());
+    n += prefix.size();
+    std::memcpy(info + n, label.data(), label.size());
+    n += label.size();
+    info[n++] = 0;  // context为空
+
+    EVP_KDF* kdf = EVP_KDF_fetch(nullptr, "HKDF", nullptr);
+    if (!kdf) {
+        return false;
+    }
+    EVP_KDF_CTX* kctx = EVP_KDF_CTX_new(kdf);
+    EVP_KDF_free(kdf);
+    if (!kctx) {
+        return false;
+    }
+    int        mode = EVP_KDF_HKDF_MODE_EXPAND_ONLY;
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_int(OSSL_KDF_PARAM_MODE, &mode),
+        OSSL_PARAM_construct_utf8_string(OSSL_KDF_PARAM_DIGEST,
+                                         const_cast<char*>(digest), 0),
+        OSSL_PARAM_construct_octet_string(
+            OSSL_KDF_PARAM_KEY, const_cast<unsigned char*>(secret.data()),
+            secret.size()),
+        OSSL_PARAM_construct_octet_string(OSSL_KDF_PARAM_INFO, info, n),
+        OSSL_PARAM_construct_end()};
+    const bool ok = EVP_KDF_derive(kctx, out.data(), out.size(), params) == 1;
+    EVP_KDF_CTX_free(kctx);
+    return ok;
+}
+
+/// @brief 填充内核的crypto_info并设置到socket
+/// TLS 1.3的12字节静态IV拆分为salt(前4字节)+iv，chacha20没有salt
+template <class Info>
+bool set_crypto_info(int fd, int direction, uint16_t cipher_type,
+                     std::span<const unsigned char> key,
+                     std::span<const unsigned char> iv) {
+    Info info{};
+    info.info.version = TLS_1_3_VERSION;
+    info.info.cipher_type = cipher_type;
+    std::memcpy(info.key, key.data(), sizeof(info.key));
+    std::memcpy(info.salt, iv.data(), sizeof(info.salt));
+    std::memcpy(info.iv, iv.data() + sizeof(info.salt), sizeof(info.iv));
+    //握手后还没有用应用密钥收发过记录，序号从0开始
+    const bool ok = setsockopt(fd, SOL_TLS, direction, &info, sizeof(info)) == 0;
+    OPENSSL_cleanse(&info, sizeof(info));
+    return ok;
+}
+
+}  // namespace
+
+//----------------------------tls_context------------------------------
+
+tls_context::tls_context(const std::string& cert_file,
+                         const std::string& key_file) {
+    m_ctx = SSL_CTX_new(TLS_server_method());
+    if (!m_ctx) {
+        throw std::runtime_error("SSL_CTX_new: " + openssl_error());
+    }
+    //内核只接管TLS 1.3的流量密钥
+    SSL_CTX_set_min_proto_version(m_ctx, TLS1_3_VERSION);
+    SSL_CTX_set_ciphersuites(m_ctx, "TLS_AES_128_GCM_SHA256:"
+                                    "TLS_AES_256_GCM_SHA384:"
+                                    "TLS_CHACHA20_POLY1305_SHA256");
+    // NewSessionTicket会用应用密钥加密发送，导致内核的发送序号与实际不符
+    SSL_CTX_set_num_tickets(m_ctx, 0);
+    SSL_CTX_set_keylog_callback(m_ctx, &ktls_handshake::keylog_callback);
+
+    if (SSL_CTX_use_certificate_chain_file(m_ctx, cert_file.c_str()) != 1 ||
+        SSL_CTX_use_PrivateKey_file(m_ctx, key_file.c_str(),
+                                    SSL_FILETYPE_PEM) != 1 ||
+        SSL_CTX_check_private_key(m_ctx) != 1) {
+        std::string err = openssl_error();
+        spdlog::get("system_logger")
+            ->error("[tls_context]: load cert:{} key:{} failed: {}", cert_file,
+                    key_file, err);
+        SSL_CTX_free(m_ctx);
+        throw std::runtime_error("tls_context: " + err);
+    }
+}
+
+tls_context::~tls_context() {
+    SSL_CTX_free(m_ctx);
+}
+
+//---------------------------ktls_handshake----------------------------
+
+ktls_handshake::ktls_handshake(tls_context& ctx) {
+    m_ssl = SSL_new(ctx.get());
+    if (!m_ssl) {
+        throw std::runtime_error("SSL_new: " + openssl_error());
+    }
+    m_rbio = BIO_new(BIO_s_mem());
+    m_wbio = BIO_new(BIO_s_mem());
+    SSL_set_bio(m_ssl, m_rbio, m_wbio);
+    SSL_set_accept_state(m_ssl);
+    SSL_set_app_data(m_ssl, this);
+}
+
+ktls_handshake::~ktls_handshake() {
+    OPENSSL_cleanse(m_client_secret.data(), m_client_secret.size());
+    OPENSSL_cleanse(m_server_secret.data(), m_server_secret.size());
+    SSL_free(m_ssl);
+}
+
+void ktls_handshake::keylog_callback(const SSL* ssl, const char* line) {
+    auto* self = static_cast<ktls_handshake*>(SSL_get_app_data(ssl));
+    if (self) {
+        self->on_keylog(line);
+    }
+}
+
+void ktls_handshake::on_keylog(const char* line) {
+    //格式: <label> <client_random hex> <secret hex>
+    std::string_view str(line);
+    size_t           sp1 = str.find(' ');
+    size_t           sp2 = str.find(' ', sp1 + 1);
+    if (sp1 == std::string_view::npos || sp2 == std::string_view::npos) {
+        return;
+    }
+    std::string_view label = str.substr(0, sp1);
+    std::string_view hex = str.substr(sp2 + 1);
+
+    std::array<unsigned char, 48>* secret;
+    if (label == "CLIENT_TRAFFIC_SECRET_0") {
+        secret = &m_client_secret;
+        m_has_client_secret = true;
+    } else if (label == "SERVER_TRAFFIC_SECRET_0") {
+        secret = &m_server_secret;
+        m_has_server_secret = true;
+    } else {
+        return;
+    }
+    m_secret_len = std::min(hex.size() / 2, secret->size());
+    auto nibble = [](char c) -> unsigned char {
+        return c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+    };
+    for (size_t i = 0; i < m_secret_len; ++i) {
+        (*secret)[i] = (nibble(hex[2 * i]) << 4) | nibble(hex[2 * i + 1]);
+    }
+}
+
+ktls_handshake::status ktls_handshake::advance() {
+    if (m_output_begin < m_output_end) {
+        return status::want_write;
+    }
+    const int res = SSL_do_handshake(m_ssl);
+    if (res != 1) {
+        const int err = SSL_get_error(m_ssl, res);
+        if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) {
+            spdlog::get("system_logger")
+                ->error("[ktls_handshake:advance]: handshake failed: {}",
+                        openssl_error());
+            return status::error;
+        }
+    }
+    if (BIO_ctrl_pending(m_wbio) > 0) {
+        const int n = BIO_read(m_wbio, m_output.data(), m_output.size());
+        if (n > 0) {
+            m_output_begin = 0;
+            m_output_end = n;
+            return status::want_write;
+        }
+    }
+    return res == 1 ? status::done : status::want_read;
+}
+
+bool ktls_handshake::commit_input(size_t n) {
+    m_record_len += n;
+    if (m_record_len == record_header_size &&
+        m_record_need == record_header_size) {
+        const auto*  h = reinterpret_cast<const uint8_t*>(m_record.data());
+        const size_t len = (size_t(h[3]) << 8) | h[4];
+        // change_cipher_spec(20) alert(21) handshake(22) application_data(23)
+        if (h[0] < 20 || h[0] > 23 ||
+            len > max_record_size - record_header_size) {
+            return false;
+        }
+        m_record_need = record_header_size + len;
+    }
+    if (m_record_len == m_record_need) {
+        BIO_write(m_rbio, m_record.data(), m_record_need);
+        m_record_len = 0;
+        m_record_need = record_header_size;
+    }
+    return true;
+}
+
+bool ktls_handshake::install(int fd) {
+    auto logger = spdlog::get("system_logger");
+    if (SSL_version(m_ssl) != TLS1_3_VERSION || !m_has_client_secret ||
+        !m_has_server_secret) {
+        logger->error("[ktls_handshake:install]: no TLS 1.3 traffic secret");
+        return false;
+    }
+
+    const char* digest;
+    size_t      key_len;
+    uint16_t    cipher_type;
+    switch (SSL_CIPHER_get_protocol_id(SSL_get_current_cipher(m_ssl))) {
+    case 0x1301:  // TLS_AES_128_GCM_SHA256
+        digest = "SHA256";
+        key_len = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+        cipher_type = TLS_CIPHER_AES_GCM_128;
+        break;
+    case 0x1302:  // TLS_AES_256_GCM_SHA384
+        digest = "SHA384";
+        key_len = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+        cipher_type = TLS_CIPHER_AES_GCM_256;
+        break;
+    case 0x1303:  // TLS_CHACHA20_POLY1305_SHA256
+        digest = "SHA256";
+        key_len = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+        cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+        break;
+    default:
+        logger->error("[ktls_handshake:install]: unsupported cipher {}",
+                      cipher_name());
+        return false;
+    }
+
+    if (setsockopt(fd, SOL_TCP, TCP_ULP, "tls", sizeof("tls")) != 0) {
+        logger->error("[ktls_handshake:install]: TCP_ULP tls failed: {}",
+                      std::strerror(errno));
+        return false;
+    }
+
+    std::array<unsigned char, 32> key;
+    std::array<unsigned char, 12> iv;
+    bool                          ok = true;
+    for (int direction : {TLS_TX, TLS_RX}) {
+        std::span<const unsigned char> secret(
+            direction == TLS_TX ? m_server_secret.data()
+                                : m_client_secret.data(),
+            m_secret_len);
+        ok = hkdf_expand_label(digest, secret, "key", {key.data(), key_len}) &&
+             hkdf_expand_label(digest, secret, "iv", iv);
+        if (ok) {
+            switch (cipher_type) {
+            case TLS_CIPHER_AES_GCM_128:
+                ok = set_crypto_info<tls12_crypto_info_aes_gcm_128>(
+                    fd, direction, cipher_type, key, iv);
+                break;
+            case TLS_CIPHER_AES_GCM_256:
+                ok = set_crypto_info<tls12_crypto_info_aes_gcm_256>(
+                    fd, direction, cipher_type, key, iv);
+                break;
+            default:
+                ok = set_crypto_info<tls12_crypto_info_chacha20_poly1305>(
+                    fd, direction, cipher_type, key, iv);
+                break;
+            }
+        }
+        if (!ok) {
+            logger->error("[ktls_handshake:install]: set {} key failed: {}",
+                          direction == TLS_TX ? "TX" : "RX",
+                          std::strerror(errno));
+            break;
+        }
+    }
+    OPENSSL_cleanse(key.data(), key.size());
+    OPENSSL_cleanse(iv.data(), iv.size());
+    OPENSSL_cleanse(m_client_secret.data(), m_client_secret.size());
+    OPENSSL_cleanse(m_server_secret.data(), m_server_secret.size());
+    return ok;
+}
+
+const char* ktls_handshake::cipher_name() const {
+    return SSL_get_cipher_name(m_ssl);
+}
+
+}  // namespace yjcServer
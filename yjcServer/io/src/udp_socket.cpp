@@ -0,0 +1,289 @@
+#include <Config/util.h>
+#include <arpa/inet.h>
+#include <io/Buffer_ring.h>
+#include <io/udp_socket.h>
+#include <netinet/udp.h>
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace yjcServer {
+
+//-----------------------------udp_socket------------------------------
+
+std::optional<udp_socket> udp_socket::bind(const std::string& ip,
+                                           uint16_t           port) {
+    sockaddr_in6 addr6{};
+    sockaddr_in  addr4{};
+    sockaddr*    addr;
+    socklen_t    addr_len;
+    int          family;
+    if (inet_pton(AF_INET, ip.c_str(), &addr4.sin_addr) == 1) {
+        addr4.sin_family = AF_INET;
+        addr4.sin_port = htons(port);
+        addr = reinterpret_cast<sockaddr*>(&addr4);
+        addr_len = sizeof(addr4);
+        family = AF_INET;
+    } else if (inet_pton(AF_INET6, ip.c_str(), &addr6.sin6_addr) == 1) {
+        addr6.sin6_family = AF_INET6;
+        addr6.sin6_port = htons(port);
+        addr = reinterpret_cast<sockaddr*>(&addr6);
+        addr_len = sizeof(addr6);
+        family = AF_INET6;
+    } else {
+        spdlog::get("system_logger")
+            ->error("[udp_socket:bind]: invalid address {}", ip);
+        return std::nullopt;
+    }
+
+    const int raw_fd = socket(family, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (raw_fd < 0) {
+        spdlog::get("system_logger")
+            ->error("[udp_socket:bind]: socket failed: {}",
+                    std::strerror(errno));
+        return std::nullopt;
+    }
+    file_descriptor fd(raw_fd);
+    const int       on = 1;
+    setsockopt(raw_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::bind(raw_fd, addr, addr_len) != 0) {
+        spdlog::get("system_logger")
+            ->error("[udp_socket:bind]: bind {}:{} failed: {}", ip, port,
+                    std::strerror(errno));
+        return std::nullopt;
+    }
+    return udp_socket(std::move(fd));
+}
+
+bool udp_socket::enable_gso() {
+    //设置为0不改变发送行为，只用来探测内核是否支持UDP_SEGMENT
+    const int zero = 0;
+    m_gso = setsockopt(get_raw_fd(), SOL_UDP, UDP_SEGMENT, &zero,
+                       sizeof(zero)) == 0;
+    return m_gso;
+}
+
+//---------------------------udp_recv_stream---------------------------
+
+udp_recv_stream::udp_recv_stream(udp_socket& socket)
+    : m_fd(socket.get_raw_fd()) {
+    m_msg.msg_namelen = sizeof(sockaddr_in6);
+    m_msg.msg_controllen = 0;
+    m_sqe.on_cqe = &udp_recv_stream::on_cqe;
+    m_sqe.stream = this;
+}
+
+udp_recv_stream::~udp_recv_stream() {
+    YJC_ASSERT_MSG(!m_armed, "udp_recv_stream destroyed while armed");
+    while (m_count) {
+        release(m_pending[m_head]);
+        m_head = (m_head + 1) % max_pending;
+        --m_count;
+    }
+}
+
+void udp_recv_stream::arm() {
+    io_uring_sqe* sqe = IOUring::Instance().get_sqe();
+    io_uring_prep_recvmsg_multishot(sqe, m_fd, &m_msg, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP_ID;
+    io_uring_sqe_set_data(sqe, &m_sqe);
+    m_armed = true;
+}
+
+void udp_recv_stream::push(int res, unsigned int flags) {
+    const unsigned int buf_id = flags >> IORING_CQE_BUFFER_SHIFT;
+    std::span<char>    buf = Buffer_ring::Instance().borrow_buf(buf_id, res);
+    //缓冲区已经被借出，仍归借用者所有，不能替它归还
+    if (buf.data() == nullptr) {
+        ++m_dropped;
+        return;
+    }
+    io_uring_recvmsg_out* out =
+        io_uring_recvmsg_validate(buf.data(), res, &m_msg);
+    if (out == nullptr || m_count == max_pending) {
+        Buffer_ring::Instance().return_buf(buf_id);
+        ++m_dropped;
+        return;
+    }
+    udp_datagram& datagram = m_pending[(m_head + m_count) % max_pending];
+    datagram.peer = static_cast<const sockaddr*>(io_uring_recvmsg_name(out));
+    datagram.peer_len = std::min<socklen_t>(out->namelen, m_msg.msg_namelen);
+    datagram.payload = {
+        static_cast<char*>(io_uring_recvmsg_payload(out, &m_msg)),
+        io_uring_recvmsg_payload_length(out, res, &m_msg)};
+    datagram.truncated = out->flags & MSG_TRUNC;
+    datagram.buf_id = buf_id;
+    ++m_count;
+}
+
+void udp_recv_stream::on_cqe(SqeData* data) {
+    udp_recv_stream* self = static_cast<stream_sqe*>(data)->stream;
+    const int        res = data->cqe_res;
+    if (!(data->cqe_flag & IORING_CQE_F_MORE)) {
+        self->m_armed = false;
+    }
+
+    if (data->cqe_flag & IORING_CQE_F_BUFFER) {
+        self->push(res, data->cqe_flag);
+    } else if (res == -ECANCELED) {
+        self->m_stopped = true;
+    } else if (res < 0 && res != -ENOBUFS) {
+        spdlog::get("system_logger")
+            ->error("[udp_recv_stream]: recvmsg failed: {}",
+                    std::strerror(-res));
+    }
+
+    // multishot结束后自动重新提交；缓冲区耗尽(ENOBUFS)时等到next()再提交
+    if (!self->m_armed && !self->m_stopped && res != -ENOBUFS) {
+        self->arm();
+    }
+
+    if (self->m_waiter &&
+        (self->m_count > 0 || (self->m_stopped && !self->m_armed))) {
+        std::exchange(self->m_waiter, nullptr).resume();
+    }
+}
+
+void udp_recv_stream::next_awaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+    stream.m_waiter = handle;
+    if (!stream.m_armed) {
+        stream.arm();
+    }
+}
+
+std::optional<udp_datagram> udp_recv_stream::next_awaiter::await_resume() {
+    if (stream.m_count == 0) {
+        return std::nullopt;
+    }
+    udp_datagram datagram = stream.m_pending[stream.m_head];
+    stream.m_head = (stream.m_head + 1) % max_pending;
+    --stream.m_count;
+    return datagram;
+}
+
+void udp_recv_stream::release(const udp_datagram& datagram) {
+    Buffer_ring::Instance().return_buf(datagram.buf_id);
+}
+
+void udp_recv_stream::stop() {
+    if (m_stopped) {
+        return;
+    }
+    m_stopped = true;
+    if (m_armed) {
+        io_uring_sqe* sqe = IOUring::Instance().get_sqe();
+        io_uring_prep_cancel(sqe, &m_sqe, 0);
+        io_uring_sqe_set_data(sqe, nullptr);
+    } else if (m_waiter) {
+        std::exchange(m_waiter, nullptr).resume();
+    }
+}
+
+//---------------------------udp_send_batch----------------------------
+
+udp_send_batch::udp_send_batch(udp_socket& socket)
+    : m_fd(socket.get_raw_fd()), m_gso(socket.gso_enabled()) {
+    m_sqe.on_cqe = &udp_send_batch::on_cqe;
+    m_sqe.batch = this;
+}
+
+udp_send_batch::entry* udp_send_batch::add_entry(
+    const sockaddr* peer, socklen_t peer_len, std::span<const char> payload) {
+    if (m_size == max_messages || peer_len > sizeof(sockaddr_in6)) {
+        return nullptr;
+    }
+    entry& e = m_entries[m_size++];
+    std::memcpy(&e.peer, peer, peer_len);
+    e.iov.iov_base = const_cast<char*>(payload.data());
+    e.iov.iov_len = payload.size();
+    e.msg = {};
+    e.msg.msg_name = &e.peer;
+    e.msg.msg_namelen = peer_len;
+    e.msg.msg_iov = &e.iov;
+    e.msg.msg_iovlen = 1;
+    return &e;
+}
+
+bool udp_send_batch::add(const sockaddr* peer, socklen_t peer_len,
+                         std::span<const char> payload) {
+    return add_entry(peer, peer_len, payload) != nullptr;
+}
+
+bool udp_send_batch::add_segments(const sockaddr* peer, socklen_t peer_len,
+                                  std::span<const char> data,
+                                  uint16_t              segment_size) {
+    if (segment_size == 0) {
+        return false;
+    }
+    //一段就超过max_gso_bytes时GSO合并不了，逐个添加
+    if (!m_gso || segment_size > max_gso_bytes) {
+        while (!data.empty()) {
+            const size_t len = std::min<size_t>(segment_size, data.size());
+            if (!add(peer, peer_len, data.first(len))) {
+                return false;
+            }
+            data = data.subspan(len);
+        }
+        return true;
+    }
+
+    //每个sendmsg最多max_gso_segments段且不超过max_gso_bytes
+    const size_t per_msg =
+        std::min(max_gso_segments, max_gso_bytes / segment_size) *
+        segment_size;
+    while (!data.empty()) {
+        const size_t len = std::min(per_msg, data.size());
+        entry*       e = add_entry(peer, peer_len, data.first(len));
+        if (e == nullptr) {
+            return false;
+        }
+        if (len > segment_size) {
+            e->msg.msg_control = e->control;
+            e->msg.msg_controllen = sizeof(e->control);
+            cmsghdr* cm = CMSG_FIRSTHDR(&e->msg);
+            cm->cmsg_level = SOL_UDP;
+            cm->cmsg_type = UDP_SEGMENT;
+            cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            std::memcpy(CMSG_DATA(cm), &segment_size, sizeof(uint16_t));
+        }
+        data = data.subspan(len);
+    }
+    return true;
+}
+
+void udp_send_batch::on_cqe(SqeData* data) {
+    udp_send_batch* self = static_cast<batch_sqe*>(data)->batch;
+    if (data->cqe_res < 0) {
+        ++self->m_failed;
+    }
+    if (--self->m_remaining == 0 && self->m_waiter) {
+        std::exchange(self->m_waiter, nullptr).resume();
+    }
+}
+
+void udp_send_batch::send_awaiter::await_suspend(
+    std::coroutine_handle<> handle) {
+    batch.m_waiter = handle;
+    batch.m_failed = 0;
+    batch.m_remaining = batch.m_size;
+    for (size_t i = 0; i < batch.m_size; ++i) {
+        io_uring_sqe* sqe = IOUring::Instance().get_sqe();
+        io_uring_prep_sendmsg(sqe, batch.m_fd, &batch.m_entries[i].msg, 0);
+        //hardlink: 按顺序发送，前一条失败不会取消后面的
+        if (i + 1 < batch.m_size) {
+            sqe->flags |= IOSQE_IO_HARDLINK;
+        }
+        io_uring_sqe_set_data(sqe, &batch.m_sqe);
+    }
+}
+
+size_t udp_send_batch::send_awaiter::await_resume() {
+    const size_t failed = batch.m_failed;
+    batch.clear();
+    return failed;
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,526 @@
+#include <io/websocket.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace yjcServer {
+
+//------------------------------帧头解析-------------------------------
+
+ws_parse_status ws_parse_frame_header(std::span<const char> data,
+                                      ws_frame_header&      header) {
+    if (data.size() < 2) {
+        return ws_parse_status::incomplete;
+    }
+    const auto* p = reinterpret_cast<const uint8_t*>(data.data());
+    // RSV1~3未协商扩展，必须为0
+    if (p[0] & 0x70) {
+        return ws_parse_status::error;
+    }
+    header.fin = p[0] & 0x80;
+    header.opcode = static_cast<ws_opcode>(p[0] & 0x0F);
+    header.masked = p[1] & 0x80;
+
+    uint64_t len = p[1] & 0x7F;
+    size_t   pos = 2;
+    if (len == 126) {
+        if (data.size() < 4) {
+            return ws_parse_status::incomplete;
+        }
+        len = (uint64_t(p[2]) << 8) | p[3];
+        pos = 4;
+    } else if (len == 127) {
+        if (data.size() < 10) {
+            return ws_parse_status::incomplete;
+        }
+        len = 0;
+        for (size_t i = 2; i < 10; ++i) {
+            len = (len << 8) | p[i];
+        }
+        //最高位必须为0
+        if (len >> 63) {
+            return ws_parse_status::error;
+        }
+        pos = 10;
+    }
+    if (header.masked) {
+        if (data.size() < pos + 4) {
+            return ws_parse_status::incomplete;
+        }
+        std::memcpy(header.mask_key.data(), p + pos, 4);
+        pos += 4;
+    }
+    header.payload_len = len;
+    header.header_len = pos;
+    return ws_parse_status::ok;
+}
+
+//------------------------------去掩码---------------------------------
+
+void ws_unmask(std::span<char> payload, std::array<uint8_t, 4> mask_key,
+               uint64_t offset) {
+    //按offset旋转掩码，使payload[0]对应mask_key[offset % 4]
+    uint8_t rot[4];
+    for (size_t i = 0; i < 4; ++i) {
+        rot[i] = mask_key[(offset + i) & 3];
+    }
+    uint32_t mask32;
+    std::memcpy(&mask32, rot, sizeof(mask32));
+
+    char*        p = payload.data();
+    const size_t n = payload.size();
+    size_t       i = 0;
+#if defined(__AVX2__)
+    const __m256i mask256 = _mm256_set1_epi32(static_cast<int>(mask32));
+    for (; i + 32 <= n; i += 32) {
+        auto* addr = reinterpret_cast<__m256i*>(p + i);
+        _mm256_storeu_si256(
+            addr, _mm256_xor_si256(_mm256_loadu_si256(addr), mask256));
+    }
+#endif
+#if defined(__SSE2__)
+    const __m128i mask128 = _mm_set1_epi32(static_cast<int>(mask32));
+    for (; i + 16 <= n; i += 16) {
+        auto* addr = reinterpret_cast<__m128i*>(p + i);
+        _mm_storeu_si128(addr,
+                         _mm_xor_si128(_mm_loadu_si128(addr), mask128));
+    }
+#endif
+    const uint64_t mask64 = (uint64_t(mask32) << 32) | mask32;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, p + i, sizeof(word));
+        word ^= mask64;
+        std::memcpy(p + i, &word, sizeof(word));
+    }
+    //上面每次步进都是4的倍数，这里i & 3仍然和rot对齐
+    for (; i < n; ++i) {
+        p[i] ^= rot[i & 3];
+    }
+}
+
+//-------------------------------握手----------------------------------
+
+namespace {
+
+constexpr std::string_view ws_guid = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+/// @brief 仅用于计算Sec-WebSocket-Accept的SHA-1
+void sha1(const uint8_t* data, size_t len, uint8_t out[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                     0xC3D2E1F0};
+    auto     rol = [](uint32_t x, int n) { return (x << n) | (x >> (32 - n)); };
+
+    //消息+0x80+补零+64位长度，握手时的输入不超过两个块
+    uint8_t      block[128] = {};
+    const size_t total = ((len + 8) / 64 + 1) * 64;
+    std::memcpy(block, data, len);
+    block[len] = 0x80;
+    const uint64_t bits = uint64_t(len) * 8;
+    for (size_t i = 0; i < 8; ++i) {
+        block[total - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    }
+
+    for (size_t chunk = 0; chunk < total; chunk += 64) {
+        uint32_t w[80];
+        for (size_t i = 0; i < 16; ++i) {
+            const uint8_t* b = block + chunk + i * 4;
+            w[i] = (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) |
+                   (uint32_t(b[2]) << 8) | b[3];
+        }
+        for (size_t i = 16; i < 80; ++i) {
+            w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (size_t i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            const uint32_t tmp = rol(a, 5) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = rol(b, 30);
+            b = a;
+            a = tmp;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+    for (size_t i = 0; i < 5; ++i) {
+        out[i * 4] = static_cast<uint8_t>(h[i] >> 24);
+        out[i * 4 + 1] = static_cast<uint8_t>(h[i] >> 16);
+        out[i * 4 + 2] = static_cast<uint8_t>(h[i] >> 8);
+        out[i * 4 + 3] = static_cast<uint8_t>(h[i]);
+    }
+}
+
+/// @brief base64编码，out至少需要(len + 2) / 3 * 4字节
+size_t base64_encode(const uint8_t* data, size_t len, char* out) {
+    static constexpr char table[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (i + 1 < len) {
+            v |= uint32_t(data[i + 1]) << 8;
+        }
+        if (i + 2 < len) {
+            v |= data[i + 2];
+        }
+        out[o++] = table[(v >> 18) & 0x3F];
+        out[o++] = table[(v >> 12) & 0x3F];
+        out[o++] = i + 1 < len ? table[(v >> 6) & 0x3F] : '=';
+        out[o++] = i + 2 < len ? table[v & 0x3F] : '=';
+    }
+    return o;
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return std::tolower(static_cast<unsigned char>(x)) ==
+                      std::tolower(static_cast<unsigned char>(y));
+           });
+}
+
+/// @brief 以逗号分隔的头部值中是否包含token(不区分大小写)
+bool contains_token(std::string_view value, std::string_view token) {
+    while (!value.empty()) {
+        size_t           comma = value.find(',');
+        std::string_view item = value.substr(0, comma);
+        while (!item.empty() && (item.front() == ' ' || item.front() == '\t')) {
+            item.remove_prefix(1);
+        }
+        while (!item.empty() && (item.back() == ' ' || item.back() == '\t')) {
+            item.remove_suffix(1);
+        }
+        if (iequals(item, token)) {
+            return true;
+        }
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        value.remove_prefix(comma + 1);
+    }
+    return false;
+}
+
+}  // namespace
+
+std::string_view ws_upgrade_key(std::string_view request) {
+    if (!request.starts_with("GET ")) {
+        return {};
+    }
+    bool             upgrade = false;
+    bool             connection = false;
+    bool             version = false;
+    std::string_view key;
+
+    size_t pos = request.find("\r\n");
+    while (pos != std::string_view::npos) {
+        pos += 2;
+        size_t end = request.find("\r\n", pos);
+        if (end == std::string_view::npos || end == pos) {
+            break;  //请求头结束
+        }
+        std::string_view line = request.substr(pos, end - pos);
+        pos = end;
+
+        size_t colon = line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view name = line.substr(0, colon);
+        std::string_view value = line.substr(colon + 1);
+        while (!value.empty() && value.front() == ' ') {
+            value.remove_prefix(1);
+        }
+        while (!value.empty() && value.back() == ' ') {
+            value.remove_suffix(1);
+        }
+
+        if (iequals(name, "upgrade")) {
+            upgrade = contains_token(value, "websocket");
+        } else if (iequals(name, "connection")) {
+            connection = contains_token(value, "upgrade");
+        } else if (iequals(name, "sec-websocket-version")) {
+            version = value == "13";
+        } else if (iequals(name, "sec-websocket-key")) {
+            key = value;
+        }
+    }
+    if (!upgrade || !connection || !version) {
+        return {};
+    }
+    return key;
+}
+
+size_t ws_write_handshake_response(std::string_view key, std::span<char> out) {
+    static constexpr std::string_view head =
+        "HTTP/1.1 101 Switching Protocols\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: ";
+    static constexpr std::string_view tail = "\r\n\r\n";
+    // base64(sha1) 固定28字节
+    static constexpr size_t accept_len = 28;
+
+    //合法的key是16字节随机数的base64，即24字节
+    uint8_t input[64];
+    if (key.empty() || key.size() + ws_guid.size() > sizeof(input) ||
+        out.size() < head.size() + accept_len + tail.size()) {
+        return 0;
+    }
+    std::memcpy(input, key.data(), key.size());
+    std::memcpy(input + key.size(), ws_guid.data(), ws_guid.size());
+    uint8_t digest[20];
+    sha1(input, key.size() + ws_guid.size(), digest);
+
+    char* p = out.data();
+    std::memcpy(p, head.data(), head.size());
+    p += head.size();
+    p += base64_encode(digest, sizeof(digest), p);
+    std::memcpy(p, tail.data(), tail.size());
+    p += tail.size();
+    return p - out.data();
+}
+
+//------------------------------ws_arena-------------------------------
+
+bool ws_arena::append(std::span<const char> data) {
+    if (data.empty()) {
+        return true;
+    }
+    if (data.size() > m_limit - m_size) {
+        return false;
+    }
+    if (m_size + data.size() > m_capacity) {
+        //按2倍增长，稳态下不再分配
+        size_t capacity = std::max<size_t>(m_capacity * 2, 4096);
+        capacity = std::min(std::max(capacity, m_size + data.size()), m_limit);
+        auto buf = std::make_unique_for_overwrite<char[]>(capacity);
+        if (m_size) {
+            std::memcpy(buf.get(), m_data.get(), m_size);
+        }
+        m_data = std::move(buf);
+        m_capacity = capacity;
+    }
+    std::memcpy(m_data.get() + m_size, data.data(), data.size());
+    m_size += data.size();
+    return true;
+}
+
+//----------------------------ws_connection----------------------------
+
+ws_connection::step_status ws_connection::read_header(std::span<char>& data) {
+    ws_parse_status status;
+    if (m_header_stash_len == 0) {
+        status = ws_parse_frame_header(data, m_header);
+        if (status == ws_parse_status::incomplete) {
+            //不足一个帧头(<14字节)，暂存等待下一个缓冲区
+            std::memcpy(m_header_stash.data(), data.data(), data.size());
+            m_header_stash_len = data.size();
+            data = {};
+            return step_status::need_more;
+        }
+        if (status == ws_parse_status::ok) {
+            data = data.subspan(m_header.header_len);
+        }
+    } else {
+        const size_t old_len = m_header_stash_len;
+        const size_t take =
+            std::min(m_header_stash.size() - old_len, data.size());
+        std::memcpy(m_header_stash.data() + old_len, data.data(), take);
+        status = ws_parse_frame_header({m_header_stash.data(), old_len + take},
+                                       m_header);
+        if (status == ws_parse_status::incomplete) {
+            m_header_stash_len = old_len + take;
+            data = {};
+            return step_status::need_more;
+        }
+        if (status == ws_parse_status::ok) {
+            data = data.subspan(m_header.header_len - old_len);
+            m_header_stash_len = 0;
+        }
+    }
+    if (status == ws_parse_status::error) {
+        return step_status::error;
+    }
+
+    const auto op = static_cast<uint8_t>(m_header.opcode);
+    const bool is_control = op & 0x8;
+    //客户端帧必须带掩码
+    if (!m_header.masked) {
+        return step_status::error;
+    }
+    if (is_control) {
+        if (m_header.opcode != ws_opcode::close &&
+            m_header.opcode != ws_opcode::ping &&
+            m_header.opcode != ws_opcode::pong) {
+            return step_status::error;
+        }
+        //控制帧不能分片，负载不超过125
+        if (!m_header.fin || m_header.payload_len > max_control_payload) {
+            return step_status::error;
+        }
+    } else if (m_header.opcode == ws_opcode::continuation) {
+        if (!m_fragmented) {
+            return step_status::error;
+        }
+    } else if (m_header.opcode == ws_opcode::text ||
+               m_header.opcode == ws_opcode::binary) {
+        if (m_fragmented) {
+            return step_status::error;
+        }
+        m_message_opcode = m_header.opcode;
+        //上一条消息已交付，复用重组区
+        m_arena.clear();
+    } else {
+        return step_status::error;
+    }
+    //完整落在一个缓冲区内的帧不经过重组区，消息长度在帧头处检查
+    if (!is_control &&
+        m_header.payload_len > m_arena.limit() - m_arena.size()) {
+        return step_status::error;
+    }
+
+    m_in_frame = true;
+    m_frame_offset = 0;
+    return step_status::need_more;
+}
+
+ws_connection::step_status ws_connection::step(std::span<char>& data,
+                                               message&         out) {
+    while (true) {
+        if (!m_in_frame) {
+            if (data.empty()) {
+                return step_status::need_more;
+            }
+            if (read_header(data) == step_status::error) {
+                return step_status::error;
+            }
+            if (!m_in_frame) {
+                return step_status::need_more;
+            }
+        }
+
+        const uint64_t remaining = m_header.payload_len - m_frame_offset;
+        const size_t   take =
+            static_cast<size_t>(std::min<uint64_t>(remaining, data.size()));
+        std::span<char> chunk = data.first(take);
+        data = data.subspan(take);
+        ws_unmask(chunk, m_header.mask_key, m_frame_offset);
+
+        const bool is_control = static_cast<uint8_t>(m_header.opcode) & 0x8;
+        const bool whole_frame = m_frame_offset == 0 && take == remaining;
+
+        //快速路径: 完整的未分片帧，直接交付provided buffer中的数据
+        if (whole_frame && (is_control || (m_header.fin && !m_fragmented))) {
+            m_in_frame = false;
+            out.opcode = m_header.opcode;
+            out.payload = chunk;
+            return step_status::message;
+        }
+
+        if (is_control) {
+            std::memcpy(m_control.data() + m_control_len, chunk.data(),
+                        chunk.size());
+            m_control_len += chunk.size();
+        } else if (!m_arena.append(chunk)) {
+            return step_status::error;
+        }
+        m_frame_offset += take;
+        if (m_frame_offset < m_header.payload_len) {
+            return step_status::need_more;
+        }
+
+        //帧结束
+        m_in_frame = false;
+        if (is_control) {
+            out.opcode = m_header.opcode;
+            out.payload = {m_control.data(), m_control_len};
+            m_control_len = 0;
+            return step_status::message;
+        }
+        if (m_header.fin) {
+            m_fragmented = false;
+            out.opcode = m_message_opcode;
+            out.payload = m_arena.data();
+            return step_status::message;
+        }
+        m_fragmented = true;
+    }
+}
+
+//------------------------------ws_writer------------------------------
+
+bool ws_writer::add_frame(ws_opcode opcode, std::span<const char> payload,
+                          bool fin) {
+    if (m_frames == max_frames) {
+        return false;
+    }
+    auto&          h = m_headers[m_frames++];
+    const uint64_t len = payload.size();
+    h[0] = static_cast<char>((fin ? 0x80 : 0) | static_cast<uint8_t>(opcode));
+    size_t header_len;
+    if (len < 126) {
+        h[1] = static_cast<char>(len);
+        header_len = 2;
+    } else if (len <= 0xFFFF) {
+        h[1] = 126;
+        h[2] = static_cast<char>(len >> 8);
+        h[3] = static_cast<char>(len);
+        header_len = 4;
+    } else {
+        h[1] = 127;
+        for (size_t i = 0; i < 8; ++i) {
+            h[2 + i] = static_cast<char>(len >> (56 - 8 * i));
+        }
+        header_len = 10;
+    }
+    m_iovs[m_iov_end++] = {h.data(), header_len};
+    if (len) {
+        m_iovs[m_iov_end++] = {const_cast<char*>(payload.data()), len};
+    }
+    return true;
+}
+
+bool ws_writer::consume(size_t written) {
+    while (m_iov_begin < m_iov_end && written >= m_iovs[m_iov_begin].iov_len) {
+        written -= m_iovs[m_iov_begin].iov_len;
+        ++m_iov_begin;
+    }
+    if (m_iov_begin == m_iov_end) {
+        clear();
+        return true;
+    }
+    auto& iov = m_iovs[m_iov_begin];
+    iov.iov_base = static_cast<char*>(iov.iov_base) + written;
+    iov.iov_len -= written;
+    return false;
+}
+
+void ws_writer::prep_writev(io_uring_sqe* sqe, int fd) const {
+    auto iovs = iovecs();
+    io_uring_prep_writev(sqe, fd, iovs.data(), iovs.size(), 0);
+}
+
+}  // namespace yjcServer
@@ -0,0 +1,73 @@
+#pragma once
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+/*
+ * CPU拓扑和线程绑核
+ * 拓扑从/sys/devices/system/cpu读取，只包含当前进程允许运行的在线CPU。
+ * 放置策略:
+ *   compact  依次占满同一个NUMA节点、同一个物理核上的逻辑CPU，线程间共享缓存
+ *   scatter  先在各NUMA节点、各物理核之间轮流分配，超线程兄弟最后才用
+ *   numa     第i个线程绑定到第i % 节点数个NUMA节点的全部CPU，由内核在节点内调度
+ * 绑定后线程首次写入的内存(first-touch)由内核分配在本节点上。
+ */
+
+namespace yjcServer {
+
+/// @brief 线程放置策略
+enum class AffinityPolicy {
+    none,     //不绑定
+    compact,  //紧凑
+    scatter,  //分散
+    numa,     //按NUMA节点
+};
+
+/// @brief 解析配置中的策略名，未知的名字按none处理
+AffinityPolicy AffinityPolicyFromString(const std::string& name);
+
+/// @brief 解析"0-3,8,10-11"格式的CPU列表
+std::vector<int> ParseCpuList(const std::string& list);
+
+struct CpuInfo {
+    int id;       //逻辑CPU编号
+    int core;     //物理核编号(同一个package内唯一)
+    int package;  //物理CPU插槽
+    int node;     //NUMA节点
+};
+
+class CpuTopology {
+private:
+    std::vector<CpuInfo> m_cpus;      //按id排序
+    std::vector<int>     m_isolated;  //内核启动参数isolcpus隔离的CPU
+    std::vector<int>     m_nodes;     //出现过的NUMA节点
+
+    CpuTopology();
+
+public:
+    /// @brief 进程启动后第一次调用时读取，之后不变
+    static const CpuTopology& Instance();
+
+    const std::vector<CpuInfo>& cpus() const {
+        return m_cpus;
+    }
+    const std::vector<int>& isolated() const {
+        return m_isolated;
+    }
+    const std::vector<int>& nodes() const {
+        return m_nodes;
+    }
+};
+
+/// @brief 为count个线程分配CPU，返回每个线程允许运行的CPU，空表示不限制
+/// @param allowed 候选CPU，空表示全部
+/// @param exclude_isolated 排除被隔离的CPU(留给专门绑定上去的线程)
+std::vector<std::vector<int>> PlanAffinity(AffinityPolicy          policy,
+                                           size_t                  count,
+                                           const std::vector<int>& allowed = {},
+                                           bool exclude_isolated = true);
+
+/// @brief 把线程绑定到cpus，cpus为空时不做任何事
+bool SetThreadAffinity(pthread_t thread, const std::vector<int>& cpus);
+
+}  // namespace yjcServer
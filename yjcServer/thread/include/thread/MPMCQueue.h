@@ -0,0 +1,169 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace yjcServer {
+
+/*
+ * 有界无锁多生产者多消费者队列(Vyukov bounded MPMC)
+ * 每个槽位带一个序号: 序号==位置 表示可写，==位置+1 表示可读。
+ * 生产者/消费者各自只CAS自己的位置计数，拿到位置后独占该槽位，
+ * 不同位置的读写互不干扰，FIFO。
+ * 槽位按缓存行对齐，相邻槽位的读写不会伪共享。
+ */
+template <class T>
+class MPMCQueue {
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    const size_t            m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+    alignas(64) std::atomic<size_t> m_dequeue_pos{0};
+
+    static size_t round_up(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+
+public:
+    /// @param capacity 容量，向上取整到2的幂
+    explicit MPMCQueue(size_t capacity)
+        : m_mask(round_up(capacity) - 1),
+          m_slots(std::make_unique<Slot[]>(m_mask + 1)) {
+        for (size_t i = 0; i <= m_mask; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue() {
+        T value;
+        while (try_pop(value)) {
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /// @brief 入队，队列满时返回false且不移动value
+    bool try_push(T& value) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        Slot*  slot;
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_seq_cst,
+                        std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        ::new (slot->storage) T(std::move(value));
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief 批量入队，一次CAS占用从当前位置开始连续的空槽位
+    /// @return 实际入队的数量，队列满时为0；只移动已入队的元素
+    size_t try_push_n(T* values, size_t n) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        size_t count;
+        while (true) {
+            count = 0;
+            while (count < n &&
+                   m_slots[(pos + count) & m_mask].sequence.load(
+                       std::memory_order_acquire) == pos + count) {
+                ++count;
+            }
+            if (count == 0) {
+                const size_t seq =
+                    m_slots[pos & m_mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos) <
+                    0) {
+                    return 0;
+                }
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + count,
+                                                    std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_t i = 0; i < count; ++i) {
+            Slot* slot = &m_slots[(pos + i) & m_mask];
+            ::new (slot->storage) T(std::move(values[i]));
+            slot->sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /// @brief 出队，队列空时返回false
+    bool try_pop(T& out) {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        Slot*  slot;
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed,
+                        std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        T* value = slot->value();
+        out = std::move(*value);
+        value->~T();
+        slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief 没有已入队或正在入队的元素
+    bool empty() const noexcept {
+        return m_enqueue_pos.load(std::memory_order_seq_cst) ==
+               m_dequeue_pos.load(std::memory_order_seq_cst);
+    }
+
+    size_t capacity() const noexcept {
+        return m_mask + 1;
+    }
+
+    size_t size() const noexcept {
+        const size_t enqueue = m_enqueue_pos.load(std::memory_order_relaxed);
+        const size_t dequeue = m_dequeue_pos.load(std::memory_order_relaxed);
+        return enqueue > dequeue ? enqueue - dequeue : 0;
+    }
+};
+
+}  // namespace yjcServer
@@ -0,0 +1,224 @@
+#pragma once
+#include <thread/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <vector>
+
+/*
+ * 基于ThreadPool的并行算法
+ *   parallel_for(pool, 0, n, [&](size_t i) { ... });
+ *   parallel_for(pool, files, [](auto& file) { verify(file); });
+ *   size_t total = parallel_reduce(pool, 0, n, size_t{0}, map, std::plus<>{});
+ *   parallel_transform(pool, in.begin(), in.end(), out.begin(), f);
+ *   parallel_sort(pool, v.begin(), v.end());
+ * 区间切成若干分块，调用线程和线程池的工作线程从同一个计数器领取分块，
+ * 先做完的线程继续领取，负载自动均衡。grain为0时按线程数自动选择分块大小。
+ * 调用线程自己也执行分块，之后只等待已被领取的分块，不等待还在队列里的任务，
+ * 所以可以在线程池的任务里嵌套调用(parallel_sort就是递归调用parallel_invoke)。
+ * 分块抛出的第一个异常在调用线程重新抛出，其余未开始的分块被跳过。
+ */
+
+namespace yjcServer {
+
+namespace detail {
+
+/// @brief 一次并行调用的共享状态，晚启动的任务看到没有剩余分块直接退出
+template <class Body>
+struct parallel_job {
+    Body                body;
+    const size_t        chunks;
+    std::atomic<size_t> next{0};  //下一个未领取的分块
+    std::atomic<size_t> remaining;  //未完成的分块
+    std::atomic<bool>   done{false};
+    std::atomic<bool>   failed{false};
+    std::exception_ptr  error;
+
+    parallel_job(Body b, size_t count)
+        : body(std::move(b)), chunks(count), remaining(count) {}
+
+    /// @brief 领取并执行分块直到全部被领取
+    void drain() {
+        size_t chunk;
+        while ((chunk = next.fetch_add(1, std::memory_order_relaxed)) <
+               chunks) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    body(chunk);
+                }
+                catch (...) {
+                    if (!failed.exchange(true, std::memory_order_acq_rel)) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                done.store(true, std::memory_order_release);
+                done.notify_all();
+            }
+        }
+    }
+
+    void wait() {
+        done.wait(false, std::memory_order_acquire);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+/// @brief 并行执行body(0..chunks-1)，返回时全部完成
+template <class Body>
+void run_chunks(ThreadPool& pool, size_t chunks, Body body) {
+    if (chunks == 0) {
+        return;
+    }
+    if (chunks == 1) {
+        body(size_t{0});
+        return;
+    }
+    auto job = std::make_shared<parallel_job<Body>>(std::move(body), chunks);
+    const size_t helpers = std::min(pool.thread_count(), chunks - 1);
+    auto         helper = [job] { job->drain(); };
+    pool.push_tasks(std::vector<decltype(helper)>(helpers, helper));
+    job->drain();
+    job->wait();
+}
+
+/// @brief 分块大小: 指定了就用指定的，否则每个线程大约分到4块
+inline size_t choose_grain(const ThreadPool& pool, size_t n, size_t grain) {
+    if (grain) {
+        return grain;
+    }
+    return std::max<size_t>(1, n / ((pool.thread_count() + 1) * 4));
+}
+
+template <std::random_access_iterator It, class Compare>
+void merge_sort(ThreadPool& pool, It first, It last, Compare& comp,
+                size_t grain);
+
+}  // namespace detail
+
+/// @brief 并行执行f(a), f(b)，a在调用线程上执行，b没有被工作线程取走时也由调用线程执行
+template <class A, class B>
+void parallel_invoke(ThreadPool& pool, A&& a, B&& b) {
+    detail::run_chunks(pool, 2, [&a, &b](size_t chunk) {
+        if (chunk == 0) {
+            std::invoke(a);
+        } else {
+            std::invoke(b);
+        }
+    });
+}
+
+/// @brief 对[first, last)中的每个下标并行调用f(i)
+template <std::integral I, class F>
+void parallel_for(ThreadPool& pool, I first, I last, F&& f, size_t grain = 0) {
+    if (first >= last) {
+        return;
+    }
+    const size_t n = static_cast<size_t>(last - first);
+    grain = detail::choose_grain(pool, n, grain);
+    detail::run_chunks(pool, (n + grain - 1) / grain, [&](size_t chunk) {
+        const I begin = first + static_cast<I>(chunk * grain);
+        const I end = first + static_cast<I>(std::min(n, (chunk + 1) * grain));
+        for (I i = begin; i < end; ++i) {
+            f(i);
+        }
+    });
+}
+
+/// @brief 对range中的每个元素并行调用f(element)
+template <std::ranges::random_access_range R, class F>
+void parallel_for(ThreadPool& pool, R&& range, F&& f, size_t grain = 0) {
+    auto first = std::ranges::begin(range);
+    parallel_for(
+        pool, size_t{0}, static_cast<size_t>(std::ranges::size(range)),
+        [&](size_t i) { f(first[i]); }, grain);
+}
+
+/// @brief 并行计算 reduce(...reduce(identity, map(first))..., map(last - 1))
+/// 每个分块先单独归约，再按分块顺序合并，reduce只需要满足结合律
+template <std::integral I, class T, class Map, class Reduce>
+T parallel_reduce(ThreadPool& pool, I first, I last, T identity, Map&& map,
+                  Reduce&& reduce, size_t grain = 0) {
+    if (first >= last) {
+        return identity;
+    }
+    const size_t n = static_cast<size_t>(last - first);
+    grain = detail::choose_grain(pool, n, grain);
+    const size_t   chunks = (n + grain - 1) / grain;
+    std::vector<T> partials(chunks, identity);
+    detail::run_chunks(pool, chunks, [&](size_t chunk) {
+        const I begin = first + static_cast<I>(chunk * grain);
+        const I end = first + static_cast<I>(std::min(n, (chunk + 1) * grain));
+        T       acc = identity;
+        for (I i = begin; i < end; ++i) {
+            acc = reduce(std::move(acc), map(i));
+        }
+        partials[chunk] = std::move(acc);
+    });
+    T result = std::move(identity);
+    for (auto& partial : partials) {
+        result = reduce(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+/// @brief 对range的元素并行map再归约
+template <std::ranges::random_access_range R, class T, class Map, class Reduce>
+T parallel_reduce(ThreadPool& pool, R&& range, T identity, Map&& map,
+                  Reduce&& reduce, size_t grain = 0) {
+    auto first = std::ranges::begin(range);
+    return parallel_reduce(
+        pool, size_t{0}, static_cast<size_t>(std::ranges::size(range)),
+        std::move(identity), [&](size_t i) { return map(first[i]); }, reduce,
+        grain);
+}
+
+/// @brief 并行的 out[i] = f(first[i])，返回输出区间的末尾
+template <std::random_access_iterator In, std::random_access_iterator Out,
+          class F>
+Out parallel_transform(ThreadPool& pool, In first, In last, Out out, F&& f,
+                       size_t grain = 0) {
+    const auto n = last - first;
+    parallel_for(
+        pool, decltype(n){0}, n, [&](auto i) { out[i] = f(first[i]); }, grain);
+    return out + n;
+}
+
+/// @brief 并行归并排序(不稳定)，不超过grain个元素的子区间用std::sort
+template <std::random_access_iterator It, class Compare = std::less<>>
+void parallel_sort(ThreadPool& pool, It first, It last, Compare comp = {},
+                   size_t grain = 0) {
+    const size_t n = static_cast<size_t>(last - first);
+    if (grain == 0) {
+        grain = std::max<size_t>(2048, n / ((pool.thread_count() + 1) * 4));
+    }
+    detail::merge_sort(pool, first, last, comp, grain);
+}
+
+namespace detail {
+
+template <std::random_access_iterator It, class Compare>
+void merge_sort(ThreadPool& pool, It first, It last, Compare& comp,
+                size_t grain) {
+    if (static_cast<size_t>(last - first) <= grain) {
+        std::sort(first, last, comp);
+        return;
+    }
+    It middle = first + (last - first) / 2;
+    parallel_invoke(
+        pool, [&] { merge_sort(pool, first, middle, comp, grain); },
+        [&] { merge_sort(pool, middle, last, comp, grain); });
+    std::inplace_merge(first, middle, last, comp);
+}
+
+}  // namespace detail
+
+}  // namespace yjcServer
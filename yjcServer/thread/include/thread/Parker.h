@@ -0,0 +1,113 @@
+#pragma once
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+namespace yjcServer {
+
+/*
+ * 工作线程的休眠/唤醒(eventcount)
+ * 生产者无锁入队后只需要读一次m_sleepers，没有线程休眠时不做任何写操作。
+ * 休眠方:
+ *   uint32_t epoch = parker.prepare_park();
+ *   if (队列非空) { parker.cancel_park(); } else { parker.park(epoch); }
+ * 先登记再检查队列，和生产者的 入队->读m_sleepers 配对(都是seq_cst)，
+ * 不会丢失唤醒。底层直接用futex(std::atomic::wait不支持超时)。
+ */
+class Parker {
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+    alignas(64) std::atomic<uint32_t> m_epoch{0};
+    alignas(64) std::atomic<uint32_t> m_sleepers{0};
+
+    /// @brief m_epoch仍等于expected时休眠，timeout为空表示不超时
+    void futex_wait(uint32_t expected, const timespec* timeout) noexcept {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch),
+                FUTEX_WAIT_PRIVATE, expected, timeout, nullptr, 0);
+    }
+
+    void futex_wake(size_t n) noexcept {
+        const int count = static_cast<int>(std::min<size_t>(n, INT_MAX));
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_epoch),
+                FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+    }
+
+public:
+    /// @brief 登记为准备休眠，返回当前epoch，之后必须再检查一次队列
+    uint32_t prepare_park() noexcept {
+        m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /// @brief 再次检查发现有任务，取消休眠
+    void cancel_park() noexcept {
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// @brief 休眠直到epoch变化
+    void park(uint32_t epoch) noexcept {
+        while (m_epoch.load(std::memory_order_seq_cst) == epoch) {
+            futex_wait(epoch, nullptr);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// @brief 最多休眠timeout，被唤醒返回true，超时返回false
+    bool park_for(uint32_t epoch, std::chrono::nanoseconds timeout) noexcept {
+        using Clock = std::chrono::steady_clock;
+        const auto deadline = Clock::now() + timeout;
+        bool       woken = true;
+        while (m_epoch.load(std::memory_order_seq_cst) == epoch) {
+            const auto left = deadline - Clock::now();
+            if (left <= std::chrono::nanoseconds::zero()) {
+                woken = false;
+                break;
+            }
+            const auto ns =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(left);
+            const timespec ts{static_cast<time_t>(ns.count() / 1000000000),
+                              static_cast<long>(ns.count() % 1000000000)};
+            futex_wait(epoch, &ts);
+        }
+        m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        return woken;
+    }
+
+    /// @brief 入队后调用，有线程休眠时唤醒一个
+    void unpark_one() noexcept {
+        if (m_sleepers.load(std::memory_order_seq_cst) != 0) {
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(1);
+        }
+    }
+
+    /// @brief 批量入队后调用，唤醒最多n个休眠的线程
+    void unpark(size_t n) noexcept {
+        const uint32_t sleepers = m_sleepers.load(std::memory_order_seq_cst);
+        if (sleepers == 0) {
+            return;
+        }
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(std::min<size_t>(n, sleepers));
+    }
+
+    /// @brief 唤醒所有休眠的线程(批量入队、退出)
+    void unpark_all() noexcept {
+        m_epoch.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(INT_MAX);
+    }
+
+    uint32_t sleepers() const noexcept {
+        return m_sleepers.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace yjcServer
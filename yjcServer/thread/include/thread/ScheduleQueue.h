@@ -0,0 +1,81 @@
+#pragma once
+#include <thread/Thread.h>
+#include <atomic>
+#include <coroutine>
+#include <mutex>
+
+namespace yjcServer {
+
+/// @brief 调度队列的侵入式节点，一般就是co_await的awaiter本身，
+/// 保存在等待的协程帧中，出队后不再被队列访问
+struct schedule_node {
+    std::atomic<schedule_node*> next{nullptr};
+    std::coroutine_handle<>     handle;
+};
+
+/*
+ * 协程句柄的侵入式多生产者队列(Vyukov intrusive MPSC)
+ * 入队是一次原子交换，没有分配、没有锁；
+ * 出队方(线程池的工作线程)之间用Spinlock互斥，先进先出。
+ */
+class ScheduleQueue {
+private:
+    alignas(64) std::atomic<schedule_node*> m_tail;
+    alignas(64) schedule_node* m_head;  //只在m_pop_lock内访问
+    schedule_node m_stub;
+    Spinlock      m_pop_lock;
+
+    void push_node(schedule_node* node) noexcept {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        schedule_node* prev = m_tail.exchange(node, std::memory_order_seq_cst);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+public:
+    ScheduleQueue() : m_tail(&m_stub), m_head(&m_stub) {}
+    ScheduleQueue(const ScheduleQueue&) = delete;
+    ScheduleQueue& operator=(const ScheduleQueue&) = delete;
+
+    void push(schedule_node* node) noexcept {
+        push_node(node);
+    }
+
+    /// @brief 取出最早的节点，队列为空或生产者正在入队时返回nullptr
+    schedule_node* pop() noexcept {
+        std::lock_guard<Spinlock> lock(m_pop_lock);
+        schedule_node*            head = m_head;
+        schedule_node*            next = head->next.load(std::memory_order_acquire);
+        if (head == &m_stub) {
+            if (next == nullptr) {
+                return nullptr;
+            }
+            m_head = next;
+            head = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            m_head = next;
+            return head;
+        }
+        if (m_tail.load(std::memory_order_acquire) != head) {
+            return nullptr;
+        }
+        //head是最后一个节点，放回stub后才能把它取走
+        push_node(&m_stub);
+        next = head->next.load(std::memory_order_acquire);
+        if (next) {
+            m_head = next;
+            return head;
+        }
+        return nullptr;
+    }
+
+    /// @brief 队列确实为空(正在入队的也算非空)，用于休眠前的检查
+    bool empty() noexcept {
+        std::lock_guard<Spinlock> lock(m_pop_lock);
+        return m_head == &m_stub &&
+               m_tail.load(std::memory_order_seq_cst) == &m_stub;
+    }
+};
+
+}  // namespace yjcServer
@@ -0,0 +1,236 @@
+#pragma once
+#include <thread/th_helper.h>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <thread>
+#include <utility>
+
+/*
+ * 自旋锁
+ *   TTASLock    先读后写(test-and-test-and-set)，等待时只读自己缓存里的副本，指数退避。
+ *               不公平，无竞争时最快，适合临界区很短、竞争不激烈的地方
+ *   TicketLock  取号排队，严格先来先服务，按前面排队的人数成比例退避。
+ *               所有等待者读同一个缓存行，每次释放都让它们全部失效，线程多时扩展性差
+ *   MCSLock     每个等待者在自己的队列节点上自旋，释放时只通知下一个，先来先服务。
+ *               线程多、竞争激烈时扩展性最好，无竞争时比TTAS多一次原子交换
+ * 都满足SpinLockable(lock/try_lock/unlock)，可以直接用std::lock_guard/std::unique_lock。
+ * 持有时间长或者持有者可能被换出时用std::mutex。
+ * tests/spinlock_bench.cpp比较它们在不同线程数下的吞吐量和公平性。
+ */
+
+namespace yjcServer {
+
+template <class L>
+concept SpinLockable = requires(L& lock) {
+    lock.lock();
+    lock.unlock();
+    { lock.try_lock() } -> std::same_as<bool>;
+};
+
+/// @brief 指数退避: 每次等待的pause次数翻倍，超过上限后改为让出CPU
+class Backoff {
+public:
+    static constexpr uint32_t max_spins = 256;
+
+private:
+    uint32_t m_spins = 1;
+
+public:
+    void pause() noexcept {
+        if (m_spins <= max_spins) {
+            for (uint32_t i = 0; i < m_spins; ++i) {
+                cpu_relax();
+            }
+            m_spins <<= 1;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    void reset() noexcept {
+        m_spins = 1;
+    }
+};
+
+class TTASLock {
+private:
+    std::atomic<bool> m_locked{false};
+
+public:
+    void lock() noexcept {
+        Backoff backoff;
+        while (m_locked.exchange(true, std::memory_order_acquire)) {
+            //锁被占用时只读，不让缓存行在等待者之间来回传递
+            do {
+                backoff.pause();
+            } while (m_locked.load(std::memory_order_relaxed));
+        }
+    }
+
+    bool try_lock() noexcept {
+        return !m_locked.load(std::memory_order_relaxed) &&
+               !m_locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() noexcept {
+        m_locked.store(false, std::memory_order_release);
+    }
+};
+
+class TicketLock {
+public:
+    static constexpr uint32_t pause_per_waiter = 32;  //前面每个等待者退避的pause次数
+    static constexpr uint32_t yield_threshold = 8;  //前面排队超过这么多时让出CPU
+    static constexpr uint32_t yield_interval = 64;  //每退避这么多轮让出一次CPU(持有者可能被换出)
+
+private:
+    alignas(64) std::atomic<uint32_t> m_next{0};  //下一个号
+    alignas(64) std::atomic<uint32_t> m_serving{0};  //正在服务的号
+
+public:
+    void lock() noexcept {
+        const uint32_t ticket = m_next.fetch_add(1, std::memory_order_relaxed);
+        for (uint32_t round = 1;; ++round) {
+            const uint32_t serving = m_serving.load(std::memory_order_acquire);
+            if (serving == ticket) {
+                return;
+            }
+            const uint32_t ahead = ticket - serving;
+            if (ahead > yield_threshold || round % yield_interval == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (uint32_t i = 0; i < ahead * pause_per_waiter; ++i) {
+                cpu_relax();
+            }
+        }
+    }
+
+    bool try_lock() noexcept {
+        uint32_t next = m_next.load(std::memory_order_relaxed);
+        return m_serving.load(std::memory_order_acquire) == next &&
+               m_next.compare_exchange_strong(next, next + 1,
+                                              std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+
+    void unlock() noexcept {
+        //只有持有者修改m_serving
+        m_serving.store(m_serving.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_release);
+    }
+};
+
+class MCSLock {
+public:
+    static constexpr uint32_t yield_interval = 1024;  //在自己的节点上自旋这么多次后让出一次CPU
+
+private:
+    /// @brief 等待队列的节点，每个等待者一个，在它上面自旋
+    struct alignas(64) Node {
+        std::atomic<Node*> next{nullptr};
+        std::atomic<bool>  locked{false};
+        Node*              free_next = nullptr;  //线程本地空闲链表
+    };
+
+    /// @brief 每个线程的空闲节点，同一个线程可以同时持有多把MCSLock
+    struct NodeCache {
+        Node* head = nullptr;
+
+        ~NodeCache() {
+            while (head) {
+                delete std::exchange(head, head->free_next);
+            }
+        }
+    };
+
+    std::atomic<Node*> m_tail{nullptr};
+    Node*              m_owner = nullptr;  //持有者的节点，只有持有者访问
+
+    static NodeCache& node_cache() {
+        static thread_local NodeCache cache;
+        return cache;
+    }
+
+    static Node* new_node() {
+        NodeCache& cache = node_cache();
+        Node*      node = cache.head;
+        if (node) {
+            cache.head = node->free_next;
+        } else {
+            node = new Node();
+        }
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->locked.store(true, std::memory_order_relaxed);
+        return node;
+    }
+
+    static void free_node(Node* node) {
+        NodeCache& cache = node_cache();
+        node->free_next = cache.head;
+        cache.head = node;
+    }
+
+public:
+    void lock() {
+        Node* node = new_node();
+        Node* prev = m_tail.exchange(node, std::memory_order_acq_rel);
+        if (prev) {
+            prev->next.store(node, std::memory_order_release);
+            for (uint32_t i = 1; node->locked.load(std::memory_order_acquire);
+                 ++i) {
+                if (i % yield_interval == 0) {
+                    std::this_thread::yield();
+                } else {
+                    cpu_relax();
+                }
+            }
+        }
+        m_owner = node;
+    }
+
+    bool try_lock() {
+        Node* node = new_node();
+        Node* expected = nullptr;
+        if (!m_tail.compare_exchange_strong(expected, node,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+            free_node(node);
+            return false;
+        }
+        m_owner = node;
+        return true;
+    }
+
+    void unlock() {
+        Node* node = m_owner;
+        Node* next = node->next.load(std::memory_order_acquire);
+        if (next == nullptr) {
+            Node* expected = node;
+            if (m_tail.compare_exchange_strong(expected, nullptr,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed)) {
+                free_node(node);
+                return;
+            }
+            //后继已经入队，还没有链接到自己后面
+            while ((next = node->next.load(std::memory_order_acquire)) ==
+                   nullptr) {
+                cpu_relax();
+            }
+        }
+        next->locked.store(false, std::memory_order_release);
+        //后继链接之后不再访问这个节点，可以复用
+        free_node(node);
+    }
+};
+
+static_assert(SpinLockable<TTASLock>);
+static_assert(SpinLockable<TicketLock>);
+static_assert(SpinLockable<MCSLock>);
+
+/// @brief 默认的自旋锁
+using Spinlock = TTASLock;
+
+}  // namespace yjcServer
@@ -0,0 +1,174 @@
+#pragma once
+#include <thread/UniqueTask.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/*
+ * 线程池共享队列的优先级通道
+ * 每个优先级一条通道，通道内有截止时间的任务按截止时间出队(最早的先出)，
+ * 没有截止时间的任务按提交顺序另排一队。两队都非空时同样做平滑加权轮询，
+ * 截止时间任务出队多，源源不断的截止时间任务也不会饿死没有截止时间的任务。
+ * 通道之间按权重做平滑加权轮询: 每次取任务时非空通道的积分加上自己的权重，
+ * 积分最高的通道出队并减去所有非空通道的权重之和。
+ * 高优先级通道权重大、出队多，低优先级通道也一定会轮到，不会饿死。
+ * 不是线程安全的，由线程池的锁保护。
+ */
+
+namespace yjcServer {
+
+/// @brief 任务优先级
+enum class TaskPriority : uint8_t {
+    critical,    //延迟敏感
+    normal,      //默认
+    background,  //后台任务(压缩、预热等)
+};
+
+inline constexpr size_t task_priority_count = 3;
+
+/// @brief 提交任务时的调度选项
+struct TaskOptions {
+    using Clock = std::chrono::steady_clock;
+
+    TaskPriority      priority = TaskPriority::normal;
+    Clock::time_point deadline = Clock::time_point::max();  //默认没有截止时间
+    bool drop_expired = true;  //出队时已过截止时间: true丢弃，false照常执行并标记
+};
+
+class TaskLanes {
+public:
+    using Clock = TaskOptions::Clock;
+
+    struct Entry {
+        UniqueTask        task;
+        Clock::time_point deadline;
+        uint64_t          seq;
+        TaskPriority      priority;
+        bool              drop_expired;
+        int64_t           enqueued;  //入队时间(SteadyNanos)，统计排队时间用，0表示没有记录
+    };
+
+private:
+    struct Lane {
+        std::vector<Entry> heap;  //有截止时间的任务，小顶堆
+        std::deque<Entry>  fifo;  //没有截止时间的任务
+        int64_t            weight = 1;
+        int64_t            current = 0;  //平滑加权轮询的积分
+        int64_t            heap_current = 0;  //通道内两队之间轮询的积分
+        int64_t            fifo_current = 0;
+
+        bool empty() const noexcept {
+            return heap.empty() && fifo.empty();
+        }
+        size_t size() const noexcept {
+            return heap.size() + fifo.size();
+        }
+    };
+
+    //通道内两队都非空时，有截止时间和没有截止时间的任务按3:1出队
+    static constexpr int64_t heap_weight = 3;
+    static constexpr int64_t fifo_weight = 1;
+
+    /// @brief 两队都非空时按权重选择，返回true表示从堆中取
+    static bool pick_heap(Lane& lane) noexcept {
+        if (lane.fifo.empty()) {
+            return true;
+        }
+        if (lane.heap.empty()) {
+            return false;
+        }
+        lane.heap_current += heap_weight;
+        lane.fifo_current += fifo_weight;
+        if (lane.heap_current >= lane.fifo_current) {
+            lane.heap_current -= heap_weight + fifo_weight;
+            return true;
+        }
+        lane.fifo_current -= heap_weight + fifo_weight;
+        return false;
+    }
+
+    /// @brief 堆顶是截止时间最早、提交最早的任务
+    static bool later(const Entry& a, const Entry& b) noexcept {
+        if (a.deadline != b.deadline) {
+            return a.deadline > b.deadline;
+        }
+        return a.seq > b.seq;
+    }
+
+    std::array<Lane, task_priority_count> m_lanes;
+    uint64_t                              m_seq = 0;
+    size_t                                m_size = 0;
+
+public:
+    TaskLanes() {
+        set_weights({8, 4, 1});
+    }
+
+    /// @brief 设置各通道的权重，按critical, normal, background的顺序，不足的部分保持不变
+    void set_weights(const std::vector<size_t>& weights) {
+        for (size_t i = 0; i < weights.size() && i < m_lanes.size(); ++i) {
+            m_lanes[i].weight = std::max<int64_t>(1, weights[i]);
+        }
+    }
+
+    void push(UniqueTask&& task, const TaskOptions& options = {},
+              int64_t enqueued = 0) {
+        Lane& lane = m_lanes[static_cast<size_t>(options.priority)];
+        Entry entry{std::move(task),  options.deadline,     m_seq++,
+                    options.priority, options.drop_expired, enqueued};
+        if (options.deadline == Clock::time_point::max()) {
+            lane.fifo.push_back(std::move(entry));
+        } else {
+            lane.heap.push_back(std::move(entry));
+            std::push_heap(lane.heap.begin(), lane.heap.end(), later);
+        }
+        ++m_size;
+    }
+
+    /// @brief 按权重选一个非空通道，再在通道内选最早到期或最早提交的任务
+    bool pop(Entry& out) {
+        if (m_size == 0) {
+            return false;
+        }
+        Lane*   chosen = nullptr;
+        int64_t total = 0;
+        for (Lane& lane : m_lanes) {
+            if (lane.empty()) {
+                continue;
+            }
+            lane.current += lane.weight;
+            total += lane.weight;
+            if (chosen == nullptr || lane.current > chosen->current) {
+                chosen = &lane;
+            }
+        }
+        chosen->current -= total;
+        if (pick_heap(*chosen)) {
+            std::pop_heap(chosen->heap.begin(), chosen->heap.end(), later);
+            out = std::move(chosen->heap.back());
+            chosen->heap.pop_back();
+        } else {
+            out = std::move(chosen->fifo.front());
+            chosen->fifo.pop_front();
+        }
+        --m_size;
+        return true;
+    }
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+    size_t size(TaskPriority priority) const noexcept {
+        return m_lanes[static_cast<size_t>(priority)].size();
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+};
+
+}  // namespace yjcServer
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <thread/Spinlock.h>
 #include <atomic>
 #include <condition_variable>
 #include <functional>
@@ -8,6 +9,7 @@
 #include <shared_mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace yjcServer {
 //--------线程----------
@@ -31,6 +33,10 @@ public:
     Thread(std::function<void()> cb, const std::string&& rname);
     Thread(std::function<void()>& cb, const std::string& rname);
     Thread(std::function<void()>& cb, const std::string&& rname);
+    /// @param wait_started false时不等待线程开始运行就返回，
+    /// 可以连续创建多个线程再统一等待，getId()在waitStarted()之后才有效
+    Thread(std::function<void()> cb, const std::string& name,
+           bool wait_started);
 
     ~Thread();
 
@@ -43,28 +49,31 @@ public:
 
     void join();
 
+    /// @brief 等待线程开始运行
+    void waitStarted();
+
+    /// @brief 绑定到指定的CPU，空表示不限制
+    bool setAffinity(const std::vector<int>& cpus);
+
     //线程内获取
     static Thread*     GetThis();
     static std::string GetName();
     static void        SetName(const std::string& name);
+    static bool        SetAffinity(const std::vector<int>& cpus);
+
+    /// @brief 注册线程预热函数(创建线程局部对象、填充缓存等)，
+    /// 开启预热的ThreadPool在每个工作线程开始取任务前调用RunWarmups()
+    static void AddWarmup(std::function<void()> hook);
+    /// @brief 在当前线程依次执行注册的预热函数
+    static void RunWarmups();
 
 private:
     Thread(const Thread&) = delete;
     Thread(Thread&&) = delete;
     Thread& operator=(Thread&&) = delete;
 
-    void init();
+    void init(bool wait_started = true);
     void run();
 };
 
-//----------自旋锁------------
-class Spinlock {
-public:
-    void lock();
-    void unlock();
-
-private:
-    std::atomic_flag m_flag = ATOMIC_FLAG_INIT;
-};
-
 }  // namespace yjcServer
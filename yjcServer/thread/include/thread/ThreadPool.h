@@ -1,122 +1,1009 @@
 #pragma once
+#include <alloca.h>
+#include <Config/GlobalConfig.h>
 #include <Config/common.h>
 #include <spdlog/spdlog.h>
+#include <thread/Affinity.h>
+#include <thread/MPMCQueue.h>
+#include <thread/Parker.h>
+#include <thread/ScheduleQueue.h>
+#include <thread/TaskLanes.h>
 #include <thread/Thread.h>
+#include <thread/ThreadPoolStats.h>
+#include <thread/UniqueTask.h>
+#include <thread/WaitGroup.h>
+#include <thread/WorkStealingDeque.h>
+#include <thread/th_helper.h>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <ranges>
 
 namespace yjcServer {
 
+/// @brief 线程池的任务调度方式
+enum class ThreadPoolMode {
+    shared,         //所有线程共用一个加锁的FIFO队列
+    work_stealing,  //每个线程一个Chase-Lev队列，空闲时从其他线程窃取
+    mpmc,           //所有线程共用一个有界无锁环形队列
+};
+
+/// @brief 解析配置中的模式名，未知的名字按shared处理
+inline ThreadPoolMode ThreadPoolModeFromString(const std::string& name) {
+    if (name == "work_stealing") {
+        return ThreadPoolMode::work_stealing;
+    }
+    if (name == "mpmc") {
+        return ThreadPoolMode::mpmc;
+    }
+    return ThreadPoolMode::shared;
+}
+
+/// @brief 弹性伸缩的参数，min_threads为0且max_threads不大于初始线程数时线程数固定
+struct ElasticOptions {
+    size_t                    min_threads = 0;  //下限，0表示和初始线程数相同
+    size_t                    max_threads = 0;  //上限
+    std::chrono::microseconds target_wait{2000};  //排队时间超过它时增加线程
+    std::chrono::milliseconds idle_timeout{30000};  //多于下限的线程空闲这么久后退出
+};
+
 class ThreadPool {
 public:
     using Lock = std::unique_lock<std::mutex>;
 
+    /// @brief 队列里的任务: 可调用对象加上入队时间(统计排队时间用，0表示没有记录)
+    struct Task : UniqueTask {
+        using UniqueTask::UniqueTask;
+        int64_t enqueued = 0;
+    };
+
+    static constexpr int steal_spin_count = 64;  //休眠前自旋尝试的轮数
+
+    static constexpr size_t max_cached_nodes = 256;  //每个线程缓存的任务节点上限
+
+    static constexpr std::chrono::milliseconds elastic_sample_interval{1};  //弹性模式的采样间隔
+
+    static constexpr size_t warmup_stack_size = 256 * 1024;  //预热时预先触发缺页的栈大小
+    static constexpr size_t warmup_nodes = 64;  //预热时每个线程预先分配的任务节点
+
 private:
+    /// @brief 本地队列只能存指针，任务放在节点里，节点在线程本地缓存中复用
+    struct TaskNode {
+        Task      task;
+        TaskNode* next = nullptr;
+    };
+
+    struct NodeCache {
+        TaskNode* head = nullptr;
+        size_t    size = 0;
+
+        ~NodeCache() {
+            while (head) {
+                delete std::exchange(head, head->next);
+            }
+        }
+    };
+
+    /// @brief 每个工作线程的槽位: work_stealing模式的本地队列、统计和任务计数
+    /// 任务计数只有本线程写，不是原子读改写，汇总各槽位得到已提交未完成/正在运行的任务数
+    struct alignas(64) Worker {
+        WorkStealingDeque<TaskNode*> deque;
+        uint64_t                     rng;  //选择窃取对象的随机数状态
+        WorkerStats                  stats;  //只有本线程写
+        LocalCounter                 submitted;  //本线程提交的任务数
+        LocalCounter                 started;    //开始执行的任务数
+        LocalCounter                 finished;   //执行完(或过期丢弃)的任务数，release写
+    };
+
+    /// @brief 各槽位任务计数的和
+    struct TaskCounts {
+        uint64_t submitted = 0;
+        uint64_t started = 0;
+        uint64_t finished = 0;
+
+        size_t pending() const noexcept {
+            return submitted > finished ? submitted - finished : 0;
+        }
+        size_t running() const noexcept {
+            return started > finished ? started - finished : 0;
+        }
+    };
+
+    //工作线程按槽位存放，退出的线程在槽位被复用时回收，下面几个都由m_resize_mutex保护
     std::vector<std::shared_ptr<yjcServer::Thread>> m_threads = {};  //工作线程
-    std::vector<pid_t>                m_threadIds = {};              //线程id
-    std::queue<std::function<void()>> m_tasks = {};  //任务队列
-    size_t m_running_tasks_count = 0;  //正在运行的任务数量
-    size_t m_threads_count = 0;        //工作线程数量
-    bool   m_workers_running = false;  //线程池是否正在运行
-    bool   m_waiting = false;          //线程池退出前等待
-    std::condition_variable m_task_available_cv = {};
+    std::vector<pid_t>                m_threadIds = {};  //线程id，线程开始运行前是0
+    std::vector<bool>                 m_alive = {};  //槽位上的线程是否在运行
+    std::vector<std::vector<int>>     m_plan = {};   //每个槽位绑定的CPU
+    TaskLanes                         m_tasks = {};  //任务队列/全局注入队列，按优先级分通道
+    //每个槽位的本地队列，线程退出后保留给复用槽位的线程，析构时释放
+    std::unique_ptr<std::atomic<Worker*>[]> m_workers;
+    std::atomic<size_t> m_slot_count = 0;  //用过的槽位数量，窃取时只看这些
+    size_t              m_capacity = 0;    //槽位数量，线程数不会超过它
+    std::unique_ptr<MPMCQueue<Task>>     m_ring;  //mpmc模式的任务队列
+    std::atomic<size_t> m_shared_count = 0;  //m_tasks中的任务数量，空闲时不用加锁检查
+    std::atomic<size_t> m_critical_count = 0;  //m_tasks中critical任务的数量
+    std::atomic<size_t> m_expired_count = 0;  //超过截止时间被丢弃的任务数量
+    ThreadPoolMode                       m_mode;
+    std::atomic<size_t> m_external_submitted = 0;  //非工作线程提交的任务数量
+    std::atomic<size_t> m_drain_waiters = 0;  //在wait_for_tasks中等待的线程数，由m_mutex保护修改
+    std::atomic<size_t> m_threads_count = 0;        //运行中的工作线程数量
+    std::atomic<bool>   m_workers_running = false;  //线程池是否正在运行
+    //弹性伸缩
+    bool                     m_warmup = false;  //工作线程开始取任务前先预热
+    bool                     m_metrics = false;  //记录每个线程的统计和任务的排队时间
+    bool                     m_elastic = false;
+    std::atomic<size_t>      m_min_threads = 0;
+    std::atomic<size_t>      m_max_threads = 0;
+    std::chrono::nanoseconds m_target_wait{0};
+    std::chrono::nanoseconds m_idle_timeout{0};
+    std::atomic<int64_t>     m_next_sample = 0;  //下次采样的时间(steady_clock纳秒)
+    int64_t                  m_last_sample = 0;  //以下三个由m_resize_mutex保护
+    int64_t                  m_last_progress = 0;  //最近一次有任务完成或队列为空的采样
+    size_t                   m_last_completed = 0;
+    std::atomic<int64_t>     m_queue_wait = 0;  //最近一次估算的排队时间(纳秒)
+    std::atomic<double>      m_utilization = 0;  //执行任务的线程比例，指数平滑
+    std::mutex               m_resize_mutex;  //启动/退出工作线程
+    uint64_t                 m_config_listener = 0;  //global配置的回调id，0表示没有注册
+    WaitGroup           m_ready;  //所有工作线程完成初始化后才开始取任务
     std::condition_variable m_task_done_cv = {};
     std::mutex              m_mutex;
+    ScheduleQueue           m_handles;  //待恢复的协程，无锁入队
+    Parker                  m_parker;   //空闲工作线程在这里休眠
+
+    //当前线程所属的线程池和它在其中的下标
+    inline static thread_local ThreadPool* t_pool = nullptr;
+    inline static thread_local size_t      t_worker_index = 0;
+    inline static thread_local bool        t_deadline_missed = false;
 
 private:
-    size_t determine_thread_count(size_t thread_count) {
+    /// @brief 没有指定时使用global.thread_pool_size，也为0时等于CPU数量
+    static size_t determine_thread_count(size_t              thread_count,
+                                         const GlobalConfig& config) {
         if (thread_count) {
             return thread_count;
         }
+        if (config.thread_pool_size) {
+            return config.thread_pool_size;
+        }
         size_t count = std::thread::hardware_concurrency();
-        return count > 0 ? count : 0;
+        return count > 0 ? count : 1;
     }
 
-    void worker() {
-        std::function<void()> task;
-        while (true) {
+    /// @brief 记录提交了n个任务，在任务入队之前调用
+    void count_submitted(size_t n) {
+        if (t_pool == this) {
+            local(t_worker_index).submitted.add(n);
+        } else {
+            m_external_submitted.fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief 汇总各槽位的任务计数
+    /// 先读完成数再读提交数: 完成的任务一定先提交(完成数用release写、acquire读)，
+    /// 读到的完成数不大于中间某一时刻的值，提交数不小于那时的值，两者相等说明那一刻没有未完成的任务
+    TaskCounts task_counts() {
+        TaskCounts counts;
+        size_t     slots = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; ++i) {
+            if (Worker* worker = m_workers[i].load(std::memory_order_acquire)) {
+                counts.finished +=
+                    worker->finished.load(std::memory_order_acquire);
+                counts.started += worker->started.load(std::memory_order_acquire);
+            }
+        }
+        slots = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; ++i) {
+            if (Worker* worker = m_workers[i].load(std::memory_order_acquire)) {
+                counts.submitted +=
+                    worker->submitted.load(std::memory_order_acquire);
+            }
+        }
+        counts.submitted +=
+            m_external_submitted.load(std::memory_order_acquire);
+        return counts;
+    }
+
+    /// @brief 工作线程空闲时调用，有线程在wait_for_tasks中等待时唤醒它重新检查
+    /// 执行任务时不碰共享的变量，只在空闲时读一次等待者数量
+    void notify_drained() {
+        //和wait_for_tasks的 登记->汇总计数 配对
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_drain_waiters.load(std::memory_order_relaxed) > 0) {
             Lock lock(m_mutex);
-            m_task_available_cv.wait(lock, [this] {
-                return !m_workers_running || !m_tasks.empty();
-            });
-            if (!m_workers_running) {
+            m_task_done_cv.notify_all();
+        }
+    }
+
+    /// @brief 在工作线程上执行任务，开启统计时记入本线程的计数和直方图
+    void run_task(UniqueTask& task, int64_t enqueued) {
+        Worker& self = local(t_worker_index);
+        self.started.add();
+        if (m_metrics) {
+            const int64_t start = self.stats.begin(enqueued);
+            task();
+            self.stats.end_task(start);
+        } else {
+            task();
+        }
+        self.finished.add(1, std::memory_order_release);
+    }
+
+    void resume(schedule_node* node) {
+        if (m_metrics) {
+            WorkerStats&  stats = local(t_worker_index).stats;
+            const int64_t start = stats.begin(0);
+            node->handle.resume();
+            stats.end_resume(start);
+        } else {
+            node->handle.resume();
+        }
+    }
+
+    /// @brief 从共享队列按优先级取一个任务执行，没有返回false
+    /// 已过截止时间的任务按提交时的选项丢弃，或者照常执行并让DeadlineMissed()返回true
+    bool run_shared_task() {
+        if (m_shared_count.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        Lock lock(m_mutex);
+        TaskLanes::Entry entry;
+        if (!m_tasks.pop(entry)) {
+            return false;
+        }
+        m_shared_count.fetch_sub(1, std::memory_order_relaxed);
+        if (entry.priority == TaskPriority::critical) {
+            m_critical_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        lock.unlock();
+        const bool expired =
+            entry.deadline != TaskLanes::Clock::time_point::max() &&
+            entry.deadline < TaskLanes::Clock::now();
+        if (expired && entry.drop_expired) {
+            m_expired_count.fetch_add(1, std::memory_order_relaxed);
+            spdlog::get("task_logger")
+                ->warn("[ThreadPool] expired task dropped");
+            Worker& self = local(t_worker_index);
+            self.started.add();
+            self.finished.add(1, std::memory_order_release);
+            return true;
+        }
+        t_deadline_missed = expired;
+        run_task(entry.task, entry.enqueued);
+        t_deadline_missed = false;
+        return true;
+    }
+
+    /// @brief 在加锁的共享队列中放入n个任务
+    void push_shared(Task* tasks, size_t n, const TaskOptions& options) {
+        Lock lock(m_mutex);
+        for (size_t i = 0; i < n; ++i) {
+            const int64_t enqueued = tasks[i].enqueued;
+            m_tasks.push(std::move(tasks[i]), options, enqueued);
+        }
+        if (options.priority == TaskPriority::critical) {
+            m_critical_count.fetch_add(n, std::memory_order_relaxed);
+        }
+        m_shared_count.fetch_add(n, std::memory_order_seq_cst);
+    }
+
+    /// @brief 从环形队列取一个任务执行，没有时检查共享队列(溢出和带优先级的任务)
+    bool run_ring_task() {
+        Task task;
+        if (m_ring->try_pop(task)) {
+            run_task(task, task.enqueued);
+            return true;
+        }
+        return run_shared_task();
+    }
+
+    Worker& local(size_t index) {
+        return *m_workers[index].load(std::memory_order_relaxed);
+    }
+
+    static NodeCache& node_cache() {
+        static thread_local NodeCache cache;
+        return cache;
+    }
+
+    static TaskNode* new_node(Task&& task) {
+        NodeCache& cache = node_cache();
+        if (TaskNode* node = cache.head) {
+            cache.head = node->next;
+            --cache.size;
+            node->task = std::move(task);
+            return node;
+        }
+        return new TaskNode{std::move(task)};
+    }
+
+    /// @brief 节点回收到执行它的线程的缓存，缓存满了才释放
+    static void free_node(TaskNode* node) {
+        NodeCache& cache = node_cache();
+        if (cache.size >= max_cached_nodes) {
+            delete node;
+            return;
+        }
+        node->next = cache.head;
+        cache.head = node;
+        ++cache.size;
+    }
+
+    void run_task(TaskNode* node) {
+        Task task = std::move(node->task);
+        free_node(node);
+        run_task(task, task.enqueued);
+    }
+
+    /// @brief 从随机的其他线程窃取一个任务执行
+    bool steal(size_t index) {
+        Worker& self = local(index);
+        self.rng ^= self.rng << 13;
+        self.rng ^= self.rng >> 7;
+        self.rng ^= self.rng << 17;
+        //槽位上的线程可能已经退出，它的队列还在，里面没有任务
+        const size_t slots = m_slot_count.load(std::memory_order_acquire);
+        const size_t start = self.rng % slots;
+        for (size_t i = 0; i < slots; ++i) {
+            const size_t victim = (start + i) % slots;
+            Worker* other = m_workers[victim].load(std::memory_order_acquire);
+            TaskNode* task;
+            if (victim != index && other && other->deque.steal(task)) {
+                if (m_metrics) {
+                    self.stats.steals.add();
+                }
+                run_task(task);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief 找一个工作执行: 协程 > 本地队列 > 注入队列 > 窃取
+    bool run_one(size_t index) {
+        //协程优先，恢复后它可能很快又交回线程池
+        if (schedule_node* node = m_handles.pop()) {
+            resume(node);
+            return true;
+        }
+        //有延迟敏感的任务时先看共享队列，不排在本地队列/环形队列后面
+        if (m_critical_count.load(std::memory_order_relaxed) > 0 &&
+            run_shared_task()) {
+            return true;
+        }
+        if (m_mode == ThreadPoolMode::mpmc) {
+            return run_ring_task();
+        }
+        if (m_mode == ThreadPoolMode::work_stealing) {
+            TaskNode* task;
+            if (local(index).deque.pop(task)) {
+                run_task(task);
+                return true;
+            }
+        }
+        if (run_shared_task()) {
+            return true;
+        }
+        return m_mode == ThreadPoolMode::work_stealing && steal(index);
+    }
+
+    /// @brief 把n个任务放入队列并唤醒最多n个线程
+    /// work_stealing模式下工作线程自己提交的任务放入本地队列，其他线程的进入注入队列
+    /// mpmc模式下队列满时，工作线程提交的任务溢出到加锁队列(不能阻塞，否则可能所有线程互相等待)，
+    /// 其他线程让出CPU等待工作线程腾出位置
+    void enqueue(Task* tasks, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        count_submitted(n);
+        if (m_metrics) {
+            const int64_t now = SteadyNanos();
+            for (size_t i = 0; i < n; ++i) {
+                tasks[i].enqueued = now;
+            }
+        }
+        if (m_mode == ThreadPoolMode::mpmc) {
+            size_t pushed = 0;
+            while (pushed < n) {
+                const size_t count =
+                    m_ring->try_push_n(tasks + pushed, n - pushed);
+                pushed += count;
+                if (pushed == n) {
+                    break;
+                }
+                if (count != 0) {
+                    //放不下整批，先唤醒线程消费已入队的部分
+                    m_parker.unpark(count);
+                    continue;
+                }
+                if (t_pool == this) {
+                    push_shared(tasks + pushed, n - pushed, {});
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        } else if (m_mode == ThreadPoolMode::work_stealing && t_pool == this) {
+            auto& deque = local(t_worker_index).deque;
+            for (size_t i = 0; i < n; ++i) {
+                deque.push(new_node(std::move(tasks[i])));
+            }
+            //和休眠方的 登记->检查队列 配对，保证休眠的线程能看到新任务
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        } else {
+            push_shared(tasks, n, {});
+        }
+        spdlog::get("task_logger")->debug("[ThreadPool] {} new task add!", n);
+        m_parker.unpark(n);
+        if (m_elastic) {
+            adapt();
+        }
+    }
+
+    /// @brief 弹性模式下由提交任务的线程定期采样，不额外启动监控线程
+    /// 排队时间按Little定律估算: 排队的任务数 / 采样周期内的完成速率，
+    /// 一直没有任务完成时等于从上次有进展到现在的时间。
+    /// 估算值超过目标、没有空闲线程且未到上限时增加一个线程
+    void adapt() {
+        using namespace std::chrono;
+        const int64_t now =
+            duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+                .count();
+        if (now < m_next_sample.load(std::memory_order_relaxed)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_resize_mutex, std::try_to_lock);
+        if (!lock.owns_lock() ||
+            now < m_next_sample.load(std::memory_order_relaxed) ||
+            !m_workers_running.load(std::memory_order_acquire)) {
+            return;
+        }
+        const int64_t interval =
+            duration_cast<nanoseconds>(elastic_sample_interval).count();
+        m_next_sample.store(now + interval, std::memory_order_relaxed);
+        const TaskCounts counts = task_counts();
+        const size_t     completed = counts.finished;
+        const size_t     done = completed - m_last_completed;
+        const int64_t elapsed = now - m_last_sample;
+        m_last_completed = completed;
+        m_last_sample = now;
+        //很久没有提交任务，上一次采样已经过时，重新开始
+        if (elapsed > 16 * interval) {
+            m_last_progress = now;
+            return;
+        }
+        const size_t live = m_threads_count.load(std::memory_order_relaxed);
+        const size_t running = counts.running();
+        const size_t pending = counts.pending();
+        const size_t queued = pending > running ? pending - running : 0;
+        if (done > 0 || queued == 0) {
+            m_last_progress = now;
+        }
+        int64_t wait = 0;
+        if (queued > 0) {
+            wait = done > 0 ? elapsed * static_cast<int64_t>(queued) /
+                                  static_cast<int64_t>(done)
+                            : now - m_last_progress;
+        }
+        m_queue_wait.store(wait, std::memory_order_relaxed);
+        m_utilization.store(
+            0.8 * m_utilization.load(std::memory_order_relaxed) +
+                0.2 * std::min(1.0, static_cast<double>(running) / live),
+            std::memory_order_relaxed);
+        if (wait > m_target_wait.count() &&
+            live < m_max_threads.load(std::memory_order_relaxed) &&
+            m_parker.sleepers() == 0) {
+            spawn_workers(1);
+            spdlog::get("task_logger")
+                ->debug("[ThreadPool] queue wait {}us, thread_count = {}",
+                        wait / 1000, live + 1);
+        }
+    }
+
+    bool has_work() {
+        if (!m_handles.empty()) {
+            return true;
+        }
+        if (m_shared_count.load(std::memory_order_seq_cst) > 0) {
+            return true;
+        }
+        if (m_mode == ThreadPoolMode::mpmc) {
+            return !m_ring->empty();
+        }
+        const size_t slots = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; ++i) {
+            Worker* worker = m_workers[i].load(std::memory_order_acquire);
+            if (worker && !worker->deque.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void worker(size_t index) {
+        t_pool = this;
+        t_worker_index = index;
+        local(index).stats.last_end = SteadyNanos();
+        while (true) {
+            if (run_one(index)) {
+                continue;
+            }
+            //无锁模式下先自旋一会儿，任务往往马上就会出现
+            bool found = false;
+            if (m_mode != ThreadPoolMode::shared) {
+                for (int i = 0; i < steal_spin_count && !found; ++i) {
+                    cpu_relax();
+                    found = run_one(index);
+                }
+            }
+            if (found) {
+                continue;
+            }
+            const uint32_t epoch = m_parker.prepare_park();
+            if (has_work()) {
+                m_parker.cancel_park();
+                continue;
+            }
+            notify_drained();
+            //退出前排空已调度的协程
+            if (!m_workers_running.load(std::memory_order_acquire)) {
+                m_parker.cancel_park();
                 return;
             }
-            task = std::move(m_tasks.front());
-            m_tasks.pop();
-            ++m_running_tasks_count;
-            lock.unlock();
-            task();
-            lock.lock();
-            --m_running_tasks_count;
-            if (m_waiting && !m_running_tasks_count && m_tasks.empty()) {
-                m_task_done_cv.notify_all();
+            //线程数多于上限(缩容)时空闲的线程立即退出
+            //在登记休眠之后检查，和resize的 修改上限->唤醒 配对
+            if (m_threads_count.load(std::memory_order_seq_cst) >
+                m_max_threads.load(std::memory_order_seq_cst)) {
+                m_parker.cancel_park();
+                if (retire(index, false)) {
+                    return;
+                }
+                continue;
+            }
+            //多于下限的线程空闲超时后退出
+            if (m_elastic && m_threads_count.load(std::memory_order_relaxed) >
+                                 m_min_threads.load(std::memory_order_relaxed)) {
+                if (!m_parker.park_for(epoch, m_idle_timeout) && !has_work() &&
+                    retire(index, true)) {
+                    return;
+                }
+                continue;
             }
+            m_parker.park(epoch);
         }
     }
 
+    /// @brief 空闲的工作线程退出前调用，线程数多于上限(idle时多于下限)才允许退出
+    /// 本地队列只有自己会放入任务，空闲时一定是空的
+    bool retire(size_t index, bool idle) {
+        Lock         lock(m_resize_mutex);
+        const size_t count = m_threads_count.load(std::memory_order_relaxed);
+        const size_t floor = idle
+                                 ? m_min_threads.load(std::memory_order_relaxed)
+                                 : m_max_threads.load(std::memory_order_relaxed);
+        if (count <= floor || !m_workers_running.load(std::memory_order_acquire)) {
+            return false;
+        }
+        m_threads_count.store(count - 1, std::memory_order_seq_cst);
+        m_alive[index] = false;
+        spdlog::get("task_logger")
+            ->debug("[ThreadPool] worker {} retired, thread_count = {}", index,
+                    count - 1);
+        return true;
+    }
+
+    /// @brief 在空闲的槽位上启动n个工作线程，调用者持有m_resize_mutex
+    /// 只创建线程，不等待它们开始运行，也不回收槽位上已经退出的线程，提交任务时扩容不会阻塞；
+    /// 新线程先回收槽位上的旧线程，各线程的初始化(绑核、分配本地队列、预热)并行进行，
+    /// 之后在m_ready处会合
+    void spawn_workers(size_t n) {
+        m_ready.add(n);
+        for (size_t index = 0; n > 0 && index < m_capacity; ++index) {
+            if (m_alive[index]) {
+                continue;
+            }
+            m_alive[index] = true;
+            m_threadIds[index] = 0;
+            m_threads_count.fetch_add(1, std::memory_order_seq_cst);
+            if (index >= m_slot_count.load(std::memory_order_relaxed)) {
+                m_slot_count.store(index + 1, std::memory_order_release);
+            }
+            //旧线程交给新线程回收，新线程被join时旧线程一定已经join过
+            m_threads[index] = std::make_shared<yjcServer::Thread>(
+                [this, index,
+                 previous = std::move(m_threads[index])]() mutable {
+                    if (previous) {
+                        previous->join();
+                        previous.reset();
+                    }
+                    start_worker(index);
+                },
+                "worker_" + std::to_string(index), false);
+            --n;
+        }
+    }
+
+    /// @brief 预先触发栈的缺页，之后深的调用栈不会在处理任务时缺页
+    [[gnu::noinline]] static void prefault_stack() {
+        volatile char* stack = static_cast<char*>(alloca(warmup_stack_size));
+        for (size_t i = 0; i < warmup_stack_size; i += 4096) {
+            stack[i] = 0;
+        }
+    }
+
+    /// @brief 预热当前工作线程: 栈、任务节点缓存(同时初始化malloc的线程缓存)、
+    /// 以及Thread::AddWarmup注册的线程局部对象(IOUring、协程帧缓存等)
+    void warmup() {
+        prefault_stack();
+        if (m_mode == ThreadPoolMode::work_stealing) {
+            NodeCache& cache = node_cache();
+            while (cache.size < warmup_nodes) {
+                cache.head = new TaskNode{Task(), cache.head};
+                ++cache.size;
+            }
+        }
+        Thread::RunWarmups();
+    }
+
+    /// @brief 工作线程入口: 先绑核，再在本线程分配本地队列(first-touch，内存在本NUMA节点)
+    /// 复用槽位的线程沿用之前的本地队列
+    void start_worker(size_t index) {
+        Thread::SetAffinity(m_plan[index]);
+        if (!m_workers[index].load(std::memory_order_relaxed)) {
+            auto* worker = new Worker();
+            worker->rng = 0x9E3779B97F4A7C15ULL * (index + 1);
+            m_workers[index].store(worker, std::memory_order_release);
+        }
+        if (m_warmup) {
+            warmup();
+        }
+        {
+            Lock lock(m_resize_mutex);
+            m_threadIds[index] = GetThreadId();
+        }
+        m_ready.done();
+        m_ready.wait();
+        this->worker(index);
+    }
+
+    /// @brief 等待所有已提交的任务执行完
+    /// 空闲的工作线程看到有等待者时唤醒它，它汇总各槽位的计数判断是否排空
     void wait_for_tasks() {
         Lock lock(m_mutex);
-        m_waiting = true;
-        m_task_done_cv.wait(
-            lock, [this] { return !m_running_tasks_count && m_tasks.empty(); });
-        m_waiting = false;
+        m_drain_waiters.fetch_add(1, std::memory_order_relaxed);
+        m_task_done_cv.wait(lock, [this] {
+            //和notify_drained的 完成计数->读等待者数量 配对
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return task_counts().pending() == 0;
+        });
+        m_drain_waiters.fetch_sub(1, std::memory_order_relaxed);
     }
     void threads_destroy() {
         {
-            Lock lock(m_mutex);
-            m_workers_running = false;
+            //之后不再启动或退出线程
+            Lock lock(m_resize_mutex);
+            m_workers_running.store(false, std::memory_order_release);
         }
-        m_task_available_cv.notify_all();
-        for (size_t i = 0; i < m_threads_count; ++i) {
-            m_threads[i]->join();
+        m_parker.unpark_all();
+        for (auto& thread : m_threads) {
+            if (thread) {
+                thread->join();
+            }
+        }
+        for (size_t i = 0; i < m_capacity; ++i) {
+            delete m_workers[i].exchange(nullptr, std::memory_order_relaxed);
         }
     }
 
 public:
-    ThreadPool(size_t thread_count = 0)
-        : m_threads_count(determine_thread_count(thread_count)) {
+    /// @brief 配置文件中global.thread_pool_mode指定的模式
+    static ThreadPoolMode ConfiguredMode() {
+        return ThreadPoolModeFromString(
+            GetGlobalConfig()->getLocal().thread_pool_mode);
+    }
+
+    /// @brief 配置文件中global.thread_pool_affinity指定的放置策略
+    static AffinityPolicy ConfiguredAffinity() {
+        return AffinityPolicyFromString(
+            GetGlobalConfig()->getLocal().thread_pool_affinity);
+    }
+
+    /// @brief 配置文件中global.thread_pool_min_size等指定的弹性伸缩参数
+    static ElasticOptions ConfiguredElastic() {
+        const GlobalConfig& config = GetGlobalConfig()->getLocal();
+        return {config.thread_pool_min_size, config.thread_pool_max_size,
+                std::chrono::microseconds(config.thread_pool_target_wait_us),
+                std::chrono::milliseconds(config.thread_pool_idle_timeout_ms)};
+    }
+
+    /// @param thread_count 初始线程数，0表示使用global.thread_pool_size，
+    /// 这时配置中的thread_pool_size变化后线程池随之调整
+    /// @param affinity 工作线程的放置策略，候选CPU来自global.thread_pool_cpus
+    /// @param elastic 弹性伸缩的上下限，排队时间超过目标时扩容，多出的线程空闲超时后退出
+    ThreadPool(size_t thread_count = 0, ThreadPoolMode mode = ConfiguredMode(),
+               AffinityPolicy affinity = ConfiguredAffinity(),
+               ElasticOptions elastic = ConfiguredElastic())
+        : m_mode(mode) {
+        m_workers_running = true;
+        //构造过程中会调用其他代码，持有快照而不是线程本地缓存的引用
+        const std::shared_ptr<const GlobalConfig> snapshot =
+            GetGlobalConfig()->getSnapshot();
+        const GlobalConfig& config = *snapshot;
+        const size_t        count = determine_thread_count(thread_count, config);
+        m_min_threads = elastic.min_threads
+                            ? std::min(elastic.min_threads, count)
+                            : count;
+        m_max_threads = std::max(elastic.max_threads, count);
+        m_elastic = m_min_threads < m_max_threads;
+        m_target_wait = elastic.target_wait;
+        m_idle_timeout = elastic.idle_timeout;
+        m_warmup = config.thread_pool_warmup;
+        m_metrics = config.thread_pool_metrics;
+        //运行时调整的线程数不超过槽位数量
+        m_capacity = std::max({count, m_max_threads.load(),
+                               2 * size_t{std::thread::hardware_concurrency()}});
+        if (m_mode == ThreadPoolMode::mpmc) {
+            m_ring = std::make_unique<MPMCQueue<Task>>(
+                config.thread_pool_queue_capacity);
+        }
+        m_plan = PlanAffinity(affinity, m_capacity,
+                              ParseCpuList(config.thread_pool_cpus),
+                              config.exclude_isolated_cpus);
+        m_tasks.set_weights(config.thread_pool_lane_weights);
+        m_threads.resize(m_capacity);
+        m_threadIds.resize(m_capacity);
+        m_alive.resize(m_capacity);
+        m_workers = std::make_unique<std::atomic<Worker*>[]>(m_capacity);
         {
-            Lock lock(m_mutex);
-            m_workers_running = true;
+            Lock lock(m_resize_mutex);
+            spawn_workers(count);
         }
-        for (size_t i = 0; i < m_threads_count; ++i) {
-            auto thread =
-                std::make_shared<yjcServer::Thread>([this] { worker(); });
-            m_threads.emplace_back(thread);
-            m_threadIds.push_back(thread->getId());
+        m_ready.wait();
+        if (thread_count == 0) {
+            m_config_listener = GetGlobalConfig()->addListener(
+                [this](const GlobalConfig& old_value,
+                       const GlobalConfig& new_value) {
+                    if (new_value.thread_pool_size &&
+                        new_value.thread_pool_size != old_value.thread_pool_size) {
+                        resize(new_value.thread_pool_size);
+                    }
+                });
         }
         spdlog::get("task_logger")
-            ->debug("\nThreadPool启动! thread_count = {}\n;", m_threads_count);
+            ->debug("\nThreadPool启动! thread_count = {}\n;", count);
     }
 
     ~ThreadPool() {
+        if (m_config_listener) {
+            GetGlobalConfig()->delListener(m_config_listener);
+        }
         wait_for_tasks();
         threads_destroy();
     }
 
+    /// @brief 运行时调整线程数，不超过构造时确定的槽位数量
+    /// 弹性模式下调整的是下限(上限不小于它)，多出的线程空闲超时后退出；
+    /// 否则上下限都等于count，多出的线程空闲时立即退出
+    void resize(size_t count) {
+        count = std::clamp<size_t>(count, 1, m_capacity);
+        Lock lock(m_resize_mutex);
+        if (!m_workers_running.load(std::memory_order_acquire)) {
+            return;
+        }
+        m_min_threads.store(count, std::memory_order_seq_cst);
+        if (!m_elastic || m_max_threads.load(std::memory_order_relaxed) < count) {
+            m_max_threads.store(count, std::memory_order_seq_cst);
+        }
+        const size_t live = m_threads_count.load(std::memory_order_relaxed);
+        if (live < count) {
+            spawn_workers(count - live);
+        }
+        lock.unlock();
+        //唤醒空闲的线程检查是否应该退出
+        m_parker.unpark_all();
+        spdlog::get("task_logger")
+            ->debug("[ThreadPool] resize to {}, thread_count = {}", count,
+                    m_threads_count.load());
+    }
+
+    /// @brief 提交任务，可调用对象和参数按值保存(可以是只能移动的类型)，不使用std::bind
+    /// 不超过UniqueTask::inline_size的任务提交时不分配内存
     template <class F, class... A>
+    requires(!std::is_same_v<std::decay_t<F>, TaskOptions>)
     void push_task(F&& task, A&&... args) {
-        {
-            Lock lock(m_mutex);
-            m_tasks.push(
-                std::bind(std::forward<F>(task), std::forward<A>(args)...));
+        Task bound(std::forward<F>(task), std::forward<A>(args)...);
+        enqueue(&bound, 1);
+    }
+
+    /// @brief 按优先级/截止时间提交，任务进入共享队列的对应通道
+    ///   pool.push_task({TaskPriority::critical}, handle, request);
+    ///   pool.push_task({TaskPriority::normal, Clock::now() + 50ms}, reply, conn);
+    template <class F, class... A>
+    void push_task(const TaskOptions& options, F&& task, A&&... args) {
+        Task bound(std::forward<F>(task), std::forward<A>(args)...);
+        if (m_metrics) {
+            bound.enqueued = SteadyNanos();
+        }
+        count_submitted(1);
+        push_shared(&bound, 1, options);
+        m_parker.unpark_one();
+        if (m_elastic) {
+            adapt();
+        }
+    }
+
+    /// @brief 批量提交，整批只加一次锁(mpmc模式一次CAS占用连续槽位)，按任务数唤醒线程
+    /// tasks的元素是无参可调用对象，右值的range会被移动
+    template <std::ranges::input_range R>
+    void push_tasks(R&& tasks) {
+        std::vector<Task> batch;
+        for (auto&& task : tasks) {
+            if constexpr (std::is_lvalue_reference_v<R>) {
+                batch.emplace_back(task);
+            } else {
+                batch.emplace_back(std::move(task));
+            }
+        }
+        enqueue(batch.data(), batch.size());
+    }
+
+    /// @brief 批量提交，group计数加上任务数，每个任务结束后done()
+    /// 调用者用group.wait()只等待这一批，不需要等整个线程池空闲
+    template <std::ranges::input_range R>
+    void push_tasks(R&& tasks, WaitGroup& group) {
+        std::vector<Task> batch;
+        for (auto&& task : tasks) {
+            using F = std::decay_t<decltype(task)>;
+            if constexpr (std::is_lvalue_reference_v<R>) {
+                batch.emplace_back(
+                    [fn = F(task), group = &group]() mutable {
+                        WaitGroup::Guard guard(*group);
+                        fn();
+                    });
+            } else {
+                batch.emplace_back(
+                    [fn = F(std::move(task)), group = &group]() mutable {
+                        WaitGroup::Guard guard(*group);
+                        fn();
+                    });
+            }
+        }
+        group.add(batch.size());
+        enqueue(batch.data(), batch.size());
+    }
+
+    /// @brief 提交任务并通过future取得结果，任务抛出的异常由future.get()重新抛出
+    template <class F, class... A,
+              class R = std::invoke_result_t<std::decay_t<F>, std::decay_t<A>...>>
+    [[nodiscard]] std::future<R> submit(F&& task, A&&... args) {
+        std::promise<R> promise;
+        std::future<R>  future = promise.get_future();
+        push_task(
+            [promise = std::move(promise),
+             fn = std::decay_t<F>(std::forward<F>(task))](
+                auto&&... params) mutable {
+                try {
+                    if constexpr (std::is_void_v<R>) {
+                        std::invoke(std::move(fn),
+                                    std::forward<decltype(params)>(params)...);
+                        promise.set_value();
+                    } else {
+                        promise.set_value(std::invoke(
+                            std::move(fn),
+                            std::forward<decltype(params)>(params)...));
+                    }
+                }
+                catch (...) {
+                    promise.set_exception(std::current_exception());
+                }
+            },
+            std::forward<A>(args)...);
+        return future;
+    }
+
+    /// @brief 调度一个协程到线程池上恢复
+    /// 节点由调用者提供(通常是awaiter本身)，只有一次原子交换，没有分配
+    void schedule(schedule_node* node) {
+        m_handles.push(node);
+        m_parker.unpark_one();
+    }
+
+    ThreadPoolMode mode() const {
+        return m_mode;
+    }
+
+    /// @brief 运行中的工作线程数量，弹性模式下会变化
+    size_t thread_count() const {
+        return m_threads_count.load(std::memory_order_relaxed);
+    }
+
+    bool elastic() const {
+        return m_elastic;
+    }
+
+    /// @brief 弹性模式下最近一次采样估算的排队时间
+    std::chrono::nanoseconds queue_wait() const {
+        return std::chrono::nanoseconds(
+            m_queue_wait.load(std::memory_order_relaxed));
+    }
+
+    /// @brief 弹性模式下正在执行任务的线程比例(指数平滑)
+    double utilization() const {
+        return m_utilization.load(std::memory_order_relaxed);
+    }
+
+    /// @brief 超过截止时间被丢弃的任务数量
+    size_t expired_count() const {
+        return m_expired_count.load(std::memory_order_relaxed);
+    }
+
+    /// @brief 在任务内调用: 当前任务是否在截止时间之后才开始执行(drop_expired为false时)
+    static bool DeadlineMissed() {
+        return t_deadline_missed;
+    }
+
+    /// @brief 统计快照: 队列深度、各工作线程的计数和忙/闲时间、排队时间和执行时间的直方图
+    /// global.thread_pool_metrics关闭时只有队列深度等计数，没有各线程的统计
+    ThreadPoolSnapshot snapshot() {
+        ThreadPoolSnapshot snap;
+        const TaskCounts counts = task_counts();
+        snap.running = counts.running();
+        snap.queued = counts.pending() > snap.running
+                          ? counts.pending() - snap.running
+                          : 0;
+        snap.shared_depth = m_shared_count.load(std::memory_order_relaxed);
+        snap.ring_depth = m_ring ? m_ring->size() : 0;
+        snap.expired = m_expired_count.load(std::memory_order_relaxed);
+        Lock lock(m_resize_mutex);
+        snap.thread_count = m_threads_count.load(std::memory_order_relaxed);
+        const size_t slots = m_slot_count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < slots; ++i) {
+            Worker* worker = m_workers[i].load(std::memory_order_acquire);
+            if (worker == nullptr) {
+                continue;
+            }
+            WorkerSnapshot w = worker->stats.snapshot();
+            w.index = i;
+            w.tid = m_threadIds[i];
+            w.alive = m_alive[i];
+            w.local_depth = worker->deque.size();
+            snap.local_depth += w.local_depth;
+            snap.tasks += w.tasks;
+            snap.steals += w.steals;
+            snap.queue_wait.merge(w.queue_wait);
+            snap.run_time.merge(w.run_time);
+            snap.workers.push_back(std::move(w));
         }
-        spdlog::get("task_logger")->debug("[ThreadPool] new task add!");
-        m_task_available_cv.notify_one();
+        return snap;
     }
 
     void print(std::shared_ptr<spdlog::logger> logger) {
-        std::string ids;
-        for (size_t i = 0; i < m_threads_count; ++i) {
-            ids += std::to_string(m_threadIds[i]);
-            if (i != m_threads_count - 1) {
-                ids += ", ";
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+        const ThreadPoolSnapshot snap = snapshot();
+        std::string              workers;
+        for (const WorkerSnapshot& w : snap.workers) {
+            if (!w.alive) {
+                continue;
             }
+            const auto total = w.busy + w.idle;
+            workers += fmt::format(
+                "  [{}] tid = {}, tasks = {}, steals = {}, busy = {:.1f}%\n",
+                w.index, w.tid, w.tasks, w.steals,
+                total.count() ? 100.0 * w.busy.count() / total.count() : 0.0);
         }
 
-        logger->info("\nthreads num = {}\n"
-                     "running task num = {}\n"
-                     "threads id : {}\n",
-                     m_threads_count, m_running_tasks_count, ids);
+        logger->info(
+            "\nthreads num = {}\n"
+            "running task num = {}\n"
+            "queued task num = {} (shared {}, ring {}, local {})\n"
+            "queue wait p50/p99 = {}us/{}us, run time p50/p99 = {}us/{}us\n"
+            "workers :\n{}",
+            snap.thread_count, snap.running, snap.queued, snap.shared_depth,
+            snap.ring_depth, snap.local_depth,
+            duration_cast<microseconds>(snap.queue_wait.percentile(0.5)).count(),
+            duration_cast<microseconds>(snap.queue_wait.percentile(0.99)).count(),
+            duration_cast<microseconds>(snap.run_time.percentile(0.5)).count(),
+            duration_cast<microseconds>(snap.run_time.percentile(0.99)).count(),
+            workers);
     }
 
 };  // class ThreadPool
@@ -0,0 +1,186 @@
+#pragma once
+#include <sys/types.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * 线程池的统计
+ * 每个工作线程一份WorkerStats，只有它自己写: 计数器是普通的 读->加->写，
+ * 不是原子读改写，热路径上没有共享的原子变量，也没有缓存行在线程之间来回传递。
+ * 其他线程随时可以读(relaxed)，snapshot()把各线程的数据汇总，数值是近似的瞬时值。
+ * 耗时按2的幂分桶，第i个桶是[2^(i-1), 2^i)纳秒，分位数取所在桶的上界。
+ */
+
+namespace yjcServer {
+
+/// @brief steady_clock的纳秒数
+inline int64_t SteadyNanos() noexcept {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// @brief 只有一个线程写的计数器
+class LocalCounter {
+private:
+    std::atomic<uint64_t> m_value{0};
+
+public:
+    void add(uint64_t          n = 1,
+             std::memory_order order = std::memory_order_relaxed) noexcept {
+        m_value.store(m_value.load(std::memory_order_relaxed) + n, order);
+    }
+
+    uint64_t load(
+        std::memory_order order = std::memory_order_relaxed) const noexcept {
+        return m_value.load(order);
+    }
+};
+
+struct HistogramSnapshot {
+    static constexpr size_t bucket_count = 48;  //最大的桶从2^46纳秒(约19小时)开始
+
+    std::array<uint64_t, bucket_count> buckets{};
+    uint64_t                           count = 0;
+    uint64_t                           sum_ns = 0;
+
+    void merge(const HistogramSnapshot& other) noexcept {
+        for (size_t i = 0; i < bucket_count; ++i) {
+            buckets[i] += other.buckets[i];
+        }
+        count += other.count;
+        sum_ns += other.sum_ns;
+    }
+
+    std::chrono::nanoseconds mean() const noexcept {
+        return std::chrono::nanoseconds(count ? sum_ns / count : 0);
+    }
+
+    /// @brief 第p(0~1)分位所在桶的上界
+    std::chrono::nanoseconds percentile(double p) const noexcept {
+        if (count == 0) {
+            return std::chrono::nanoseconds(0);
+        }
+        const uint64_t rank = static_cast<uint64_t>(p * (count - 1)) + 1;
+        uint64_t       seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                return std::chrono::nanoseconds(i == 0 ? 0 : int64_t{1} << i);
+            }
+        }
+        return std::chrono::nanoseconds(int64_t{1} << (bucket_count - 1));
+    }
+};
+
+/// @brief 只有一个线程写的耗时直方图
+class LatencyHistogram {
+private:
+    std::array<LocalCounter, HistogramSnapshot::bucket_count> m_buckets;
+    LocalCounter                                              m_sum_ns;
+
+public:
+    void record(int64_t ns) noexcept {
+        const uint64_t value = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        const size_t   bucket = std::min<size_t>(
+            std::bit_width(value), HistogramSnapshot::bucket_count - 1);
+        m_buckets[bucket].add();
+        m_sum_ns.add(value);
+    }
+
+    HistogramSnapshot snapshot() const noexcept {
+        HistogramSnapshot snap;
+        for (size_t i = 0; i < HistogramSnapshot::bucket_count; ++i) {
+            snap.buckets[i] = m_buckets[i].load();
+            snap.count += snap.buckets[i];
+        }
+        snap.sum_ns = m_sum_ns.load();
+        return snap;
+    }
+};
+
+/// @brief 一个工作线程的统计
+struct WorkerSnapshot {
+    size_t                   index = 0;  //槽位下标
+    pid_t                    tid = 0;
+    bool                     alive = false;  //弹性模式下退出的线程保留统计
+    uint64_t                 tasks = 0;      //执行的任务数
+    uint64_t                 resumes = 0;    //恢复的协程数
+    uint64_t                 steals = 0;     //从其他线程窃取的任务数
+    std::chrono::nanoseconds busy{0};  //执行任务/协程的时间
+    std::chrono::nanoseconds idle{0};  //两次执行之间的时间(找任务、自旋、休眠)
+    size_t                   local_depth = 0;  //本地队列中的任务数
+    HistogramSnapshot        queue_wait;  //任务从入队到开始执行
+    HistogramSnapshot        run_time;    //任务的执行时间
+};
+
+/// @brief 工作线程自己写的统计
+struct WorkerStats {
+    LocalCounter     tasks;
+    LocalCounter     resumes;
+    LocalCounter     steals;
+    LocalCounter     busy_ns;
+    LocalCounter     idle_ns;
+    LatencyHistogram queue_wait;
+    LatencyHistogram run_time;
+    int64_t          last_end = 0;  //上一次执行结束的时间
+
+    /// @brief 开始执行，enqueued为0表示没有入队时间，返回开始时间
+    int64_t begin(int64_t enqueued) noexcept {
+        const int64_t now = SteadyNanos();
+        idle_ns.add(now - last_end);
+        if (enqueued) {
+            queue_wait.record(now - enqueued);
+        }
+        return now;
+    }
+
+    void end_task(int64_t start) noexcept {
+        last_end = SteadyNanos();
+        busy_ns.add(last_end - start);
+        run_time.record(last_end - start);
+        tasks.add();
+    }
+
+    void end_resume(int64_t start) noexcept {
+        last_end = SteadyNanos();
+        busy_ns.add(last_end - start);
+        resumes.add();
+    }
+
+    WorkerSnapshot snapshot() const noexcept {
+        WorkerSnapshot snap;
+        snap.tasks = tasks.load();
+        snap.resumes = resumes.load();
+        snap.steals = steals.load();
+        snap.busy = std::chrono::nanoseconds(busy_ns.load());
+        snap.idle = std::chrono::nanoseconds(idle_ns.load());
+        snap.queue_wait = queue_wait.snapshot();
+        snap.run_time = run_time.snapshot();
+        return snap;
+    }
+};
+
+/// @brief 线程池的统计快照
+struct ThreadPoolSnapshot {
+    size_t thread_count = 0;
+    size_t running = 0;  //正在执行的任务数
+    size_t queued = 0;   //已提交还没开始执行的任务数(队列深度)
+    size_t shared_depth = 0;  //共享队列(按优先级分通道)中的任务数
+    size_t ring_depth = 0;    //mpmc模式环形队列中的任务数
+    size_t local_depth = 0;   //work_stealing模式各本地队列中的任务数之和
+    size_t expired = 0;       //超过截止时间被丢弃的任务数
+    uint64_t                    tasks = 0;
+    uint64_t                    steals = 0;
+    std::vector<WorkerSnapshot> workers;
+    HistogramSnapshot           queue_wait;  //所有线程合并
+    HistogramSnapshot           run_time;
+};
+
+}  // namespace yjcServer
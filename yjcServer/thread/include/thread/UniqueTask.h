@@ -0,0 +1,143 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace yjcServer {
+
+/*
+ * 只能移动的 void() 可调用对象，线程池的任务类型
+ *   UniqueTask t([fd = std::move(fd)]() mutable { ... });  //可以捕获只能移动的对象
+ *   UniqueTask t(fun, arg1, arg2);                         //参数按值保存，调用时移动传入
+ * 不超过inline_size且移动不抛异常的可调用对象直接放在对象内部，不分配内存；
+ * 更大的放到堆上。和std::thread一样，绑定的参数以右值传给函数，只应调用一次。
+ */
+class UniqueTask {
+public:
+    static constexpr size_t inline_size = 64;
+
+private:
+    struct VTable {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src) noexcept;  //移动到dst并析构src
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <class F>
+    static constexpr bool is_inline =
+        sizeof(F) <= inline_size && alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    /// @brief 对象内部存放的可调用对象
+    template <class F>
+    static constexpr VTable inline_vtable = {
+        [](void* storage) { (*static_cast<F*>(storage))(); },
+        [](void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        },
+        [](void* storage) noexcept { static_cast<F*>(storage)->~F(); },
+    };
+
+    /// @brief 堆上的可调用对象，对象内部只放指针
+    template <class F>
+    static constexpr VTable heap_vtable = {
+        [](void* storage) { (**static_cast<F**>(storage))(); },
+        [](void* dst, void* src) noexcept {
+            *static_cast<F**>(dst) = *static_cast<F**>(src);
+        },
+        [](void* storage) noexcept { delete *static_cast<F**>(storage); },
+    };
+
+    /// @brief 函数和绑定的参数
+    template <class F, class... A>
+    struct Bound {
+        F                   fn;
+        std::tuple<A...>    args;
+
+        void operator()() {
+            std::apply(
+                [this](A&... a) { std::invoke(std::move(fn), std::move(a)...); },
+                args);
+        }
+    };
+
+    alignas(std::max_align_t) unsigned char m_storage[inline_size];
+    const VTable* m_vtable = nullptr;
+
+    template <class F, class... Args>
+    void emplace(Args&&... args) {
+        if constexpr (is_inline<F>) {
+            ::new (static_cast<void*>(m_storage)) F(std::forward<Args>(args)...);
+            m_vtable = &inline_vtable<F>;
+        } else {
+            *reinterpret_cast<F**>(m_storage) =
+                new F(std::forward<Args>(args)...);
+            m_vtable = &heap_vtable<F>;
+        }
+    }
+
+    void reset() noexcept {
+        if (m_vtable) {
+            m_vtable->destroy(m_storage);
+            m_vtable = nullptr;
+        }
+    }
+
+public:
+    UniqueTask() noexcept = default;
+
+    template <class F>
+    requires(!std::is_same_v<std::decay_t<F>, UniqueTask> &&
+             std::is_invocable_v<std::decay_t<F>&>)
+    UniqueTask(F&& fn) {
+        emplace<std::decay_t<F>>(std::forward<F>(fn));
+    }
+
+    template <class F, class A0, class... A>
+    requires std::is_invocable_v<std::decay_t<F>, std::decay_t<A0>,
+                                 std::decay_t<A>...>
+    UniqueTask(F&& fn, A0&& arg0, A&&... args) {
+        using B = Bound<std::decay_t<F>, std::decay_t<A0>, std::decay_t<A>...>;
+        emplace<B>(B{std::forward<F>(fn),
+                     {std::forward<A0>(arg0), std::forward<A>(args)...}});
+    }
+
+    UniqueTask(UniqueTask&& other) noexcept : m_vtable(other.m_vtable) {
+        if (m_vtable) {
+            m_vtable->move(m_storage, other.m_storage);
+            other.m_vtable = nullptr;
+        }
+    }
+
+    UniqueTask& operator=(UniqueTask&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.m_vtable) {
+                other.m_vtable->move(m_storage, other.m_storage);
+                m_vtable = std::exchange(other.m_vtable, nullptr);
+            }
+        }
+        return *this;
+    }
+
+    UniqueTask(const UniqueTask&) = delete;
+    UniqueTask& operator=(const UniqueTask&) = delete;
+
+    ~UniqueTask() {
+        reset();
+    }
+
+    void operator()() {
+        m_vtable->invoke(m_storage);
+    }
+
+    explicit operator bool() const noexcept {
+        return m_vtable != nullptr;
+    }
+};
+
+}  // namespace yjcServer
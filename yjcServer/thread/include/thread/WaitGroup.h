@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace yjcServer {
+
+/*
+ * 等待一批任务完成
+ *   WaitGroup group;
+ *   pool.push_tasks(jobs, group);  //或者 group.add(1); pool.push_task([&] {...; group.done();});
+ *   group.wait();                  //只等这一批，线程池里其他任务不受影响
+ * 计数归零前可以继续add，可以反复使用。
+ */
+class WaitGroup {
+private:
+    std::atomic<size_t>     m_count{0};
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+
+public:
+    /// @brief 任务结束时调用done()，异常退出也一样
+    class Guard {
+    private:
+        WaitGroup& m_group;
+
+    public:
+        explicit Guard(WaitGroup& group) : m_group(group) {}
+        ~Guard() {
+            m_group.done();
+        }
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+
+    WaitGroup() = default;
+    WaitGroup(const WaitGroup&) = delete;
+    WaitGroup& operator=(const WaitGroup&) = delete;
+
+    void add(size_t n = 1) noexcept {
+        m_count.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void done() {
+        size_t count = m_count.load(std::memory_order_relaxed);
+        while (count > 1) {
+            if (m_count.compare_exchange_weak(count, count - 1,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        //最后一次在锁内减到0，等待者拿到锁之前不会返回并销毁WaitGroup
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_cv.notify_all();
+        }
+    }
+
+    /// @brief 计数在锁内归零，拿到锁看到0时done()已经离开临界区
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] {
+            return m_count.load(std::memory_order_acquire) == 0;
+        });
+    }
+
+    size_t count() const noexcept {
+        return m_count.load(std::memory_order_relaxed);
+    }
+};
+
+}  // namespace yjcServer
@@ -0,0 +1,125 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace yjcServer {
+
+/*
+ * Chase-Lev工作窃取双端队列(Lê et al. 2013的C11版本)
+ * 所属线程在bottom端push/pop(LIFO，缓存里最热的任务先执行)，
+ * 其他线程在top端steal(FIFO，偷走最老、通常也是最大的任务)。
+ * 只有两端竞争最后一个元素时才需要CAS。
+ * 数组满时所属线程扩容为两倍，旧数组可能还在被窃取者读取，留到析构时释放。
+ * T必须可以平凡拷贝(一般是指针)。
+ */
+template <class T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+private:
+    struct Array {
+        const int64_t                   capacity;
+        const int64_t                   mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(int64_t cap)
+            : capacity(cap),
+              mask(cap - 1),
+              slots(std::make_unique<std::atomic<T>[]>(cap)) {}
+
+        T get(int64_t i) const noexcept {
+            return slots[i & mask].load(std::memory_order_relaxed);
+        }
+        void put(int64_t i, T value) noexcept {
+            slots[i & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    alignas(64) std::atomic<Array*> m_array;
+    std::vector<std::unique_ptr<Array>> m_arrays;  //当前和退役的数组，只由所属线程修改
+
+    Array* grow(Array* old, int64_t bottom, int64_t top) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (int64_t i = top; i < bottom; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Array* array = bigger.get();
+        m_arrays.push_back(std::move(bigger));
+        m_array.store(array, std::memory_order_release);
+        return array;
+    }
+
+public:
+    /// @param capacity 初始容量，必须是2的幂
+    explicit WorkStealingDeque(int64_t capacity = 1024) {
+        m_arrays.push_back(std::make_unique<Array>(capacity));
+        m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+    }
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /// @brief 所属线程压入bottom端
+    void push(T value) {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_acquire);
+        Array*        a = m_array.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, value);
+        m_bottom.store(b + 1, std::memory_order_release);
+    }
+
+    /// @brief 所属线程从bottom端取出最新的元素
+    bool pop(T& out) {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array*        a = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = m_top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        out = a->get(b);
+        if (t == b) {
+            //最后一个元素，和窃取者竞争
+            const bool won = m_top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    /// @brief 其他线程从top端窃取最老的元素，失败(空或竞争失败)返回false
+    bool steal(T& out) {
+        int64_t       t = m_top.load(std::memory_order_seq_cst);
+        const int64_t b = m_bottom.load(std::memory_order_seq_cst);
+        if (t >= b) {
+            return false;
+        }
+        Array* a = m_array.load(std::memory_order_acquire);
+        out = a->get(t);
+        return m_top.compare_exchange_strong(
+            t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        const int64_t b = m_bottom.load(std::memory_order_seq_cst);
+        const int64_t t = m_top.load(std::memory_order_seq_cst);
+        return b <= t;
+    }
+
+    size_t size() const noexcept {
+        const int64_t b = m_bottom.load(std::memory_order_relaxed);
+        const int64_t t = m_top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+};
+
+}  // namespace yjcServer
@@ -7,4 +7,13 @@ namespace yjcServer {
 inline pid_t GetThreadId() {
     return syscall(SYS_gettid);
 }
+
+/// @brief 自旋等待时让出流水线，降低功耗和对超线程兄弟的干扰
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
 }  // namespace yjcServer
\ No newline at end of file
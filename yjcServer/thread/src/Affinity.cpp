@@ -0,0 +1,218 @@
+#include <sched.h>
+#include <spdlog/spdlog.h>
+#include <thread/Affinity.h>
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+namespace yjcServer {
+
+namespace fs = std::filesystem;
+
+static int ReadInt(const fs::path& path, int default_value) {
+    std::ifstream in(path);
+    int           value;
+    if (in >> value) {
+        return value;
+    }
+    return default_value;
+}
+
+static std::string ReadLine(const fs::path& path) {
+    std::ifstream in(path);
+    std::string   line;
+    std::getline(in, line);
+    return line;
+}
+
+AffinityPolicy AffinityPolicyFromString(const std::string& name) {
+    if (name == "compact") {
+        return AffinityPolicy::compact;
+    }
+    if (name == "scatter") {
+        return AffinityPolicy::scatter;
+    }
+    if (name == "numa") {
+        return AffinityPolicy::numa;
+    }
+    return AffinityPolicy::none;
+}
+
+std::vector<int> ParseCpuList(const std::string& list) {
+    std::vector<int>  cpus;
+    std::stringstream ss(list);
+    std::string       item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        try {
+            const size_t dash = item.find('-');
+            const int    first = std::stoi(item.substr(0, dash));
+            const int    last = dash == std::string::npos
+                                    ? first
+                                    : std::stoi(item.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (const std::exception&) {
+            spdlog::get("system_logger")
+                ->error("invalid cpu list item: {}", item);
+        }
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+CpuTopology::CpuTopology() {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    const bool has_mask = sched_getaffinity(0, sizeof(mask), &mask) == 0;
+    const fs::path root("/sys/devices/system/cpu");
+    for (int id : ParseCpuList(ReadLine(root / "online"))) {
+        if (has_mask && !CPU_ISSET(id, &mask)) {
+            continue;
+        }
+        const fs::path dir = root / ("cpu" + std::to_string(id));
+        CpuInfo        cpu{id, ReadInt(dir / "topology/core_id", id),
+                    ReadInt(dir / "topology/physical_package_id", 0), 0};
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(dir, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.rfind("node", 0) == 0 && name.size() > 4 &&
+                std::isdigit(static_cast<unsigned char>(name[4]))) {
+                cpu.node = std::stoi(name.substr(4));
+                break;
+            }
+        }
+        m_cpus.push_back(cpu);
+        m_nodes.push_back(cpu.node);
+    }
+    //没有sysfs时退回到affinity掩码
+    if (m_cpus.empty()) {
+        for (int id = 0; id < CPU_SETSIZE; ++id) {
+            if (has_mask && CPU_ISSET(id, &mask)) {
+                m_cpus.push_back(CpuInfo{id, id, 0, 0});
+            }
+        }
+        m_nodes.push_back(0);
+    }
+    std::sort(m_nodes.begin(), m_nodes.end());
+    m_nodes.erase(std::unique(m_nodes.begin(), m_nodes.end()), m_nodes.end());
+    m_isolated = ParseCpuList(ReadLine(root / "isolated"));
+}
+
+const CpuTopology& CpuTopology::Instance() {
+    static CpuTopology topology;
+    return topology;
+}
+
+std::vector<std::vector<int>> PlanAffinity(AffinityPolicy          policy,
+                                           size_t                  count,
+                                           const std::vector<int>& allowed,
+                                           bool exclude_isolated) {
+    std::vector<std::vector<int>> plan(count);
+    if (policy == AffinityPolicy::none || count == 0) {
+        return plan;
+    }
+    const CpuTopology&   topology = CpuTopology::Instance();
+    std::vector<CpuInfo> cpus;
+    for (const CpuInfo& cpu : topology.cpus()) {
+        if (!allowed.empty() &&
+            !std::binary_search(allowed.begin(), allowed.end(), cpu.id)) {
+            continue;
+        }
+        if (exclude_isolated &&
+            std::binary_search(topology.isolated().begin(),
+                               topology.isolated().end(), cpu.id)) {
+            continue;
+        }
+        cpus.push_back(cpu);
+    }
+    if (cpus.empty()) {
+        spdlog::get("system_logger")
+            ->error("PlanAffinity: no usable cpu, threads are not pinned");
+        return plan;
+    }
+
+    if (policy == AffinityPolicy::numa) {
+        std::map<int, std::vector<int>> nodes;
+        for (const CpuInfo& cpu : cpus) {
+            nodes[cpu.node].push_back(cpu.id);
+        }
+        std::vector<const std::vector<int>*> node_cpus;
+        for (auto& [node, ids] : nodes) {
+            node_cpus.push_back(&ids);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            plan[i] = *node_cpus[i % node_cpus.size()];
+        }
+        return plan;
+    }
+
+    //同一个物理核上的第几个逻辑CPU(超线程序号)
+    std::map<std::tuple<int, int, int>, int> siblings;
+    std::vector<std::pair<CpuInfo, int>>     ranked;
+    for (const CpuInfo& cpu : cpus) {
+        ranked.emplace_back(cpu, siblings[{cpu.node, cpu.package, cpu.core}]++);
+    }
+    if (policy == AffinityPolicy::compact) {
+        std::sort(ranked.begin(), ranked.end(), [](auto& a, auto& b) {
+            return std::tie(a.first.node, a.first.package, a.first.core,
+                            a.second) < std::tie(b.first.node, b.first.package,
+                                                 b.first.core, b.second);
+        });
+    } else {
+        //每个节点内先排各物理核的第一个逻辑CPU，再在节点之间轮流取
+        std::map<int, std::vector<std::pair<CpuInfo, int>>> nodes;
+        for (auto& item : ranked) {
+            nodes[item.first.node].push_back(item);
+        }
+        for (auto& [node, items] : nodes) {
+            std::sort(items.begin(), items.end(), [](auto& a, auto& b) {
+                return std::tie(a.second, a.first.package, a.first.core) <
+                       std::tie(b.second, b.first.package, b.first.core);
+            });
+        }
+        ranked.clear();
+        for (size_t i = 0; ranked.size() < cpus.size(); ++i) {
+            for (auto& [node, items] : nodes) {
+                if (i < items.size()) {
+                    ranked.push_back(items[i]);
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        plan[i] = {ranked[i % ranked.size()].first.id};
+    }
+    return plan;
+}
+
+bool SetThreadAffinity(pthread_t thread, const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    const int err = pthread_setaffinity_np(thread, sizeof(mask), &mask);
+    if (err != 0) {
+        spdlog::get("system_logger")
+            ->error("pthread_setaffinity_np fail : {}", err);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace yjcServer
@@ -1,5 +1,6 @@
 #include <Config/Config.h>
 #include <spdlog/spdlog.h>
+#include <thread/Affinity.h>
 #include <thread/Thread.h>
 #include <thread/th_helper.h>
 
@@ -26,44 +27,90 @@ void Thread::SetName(const std::string& name) {
     }
     t_thread_name = name;
 }
+
+bool Thread::SetAffinity(const std::vector<int>& cpus) {
+    return SetThreadAffinity(pthread_self(), cpus);
+}
+
+//函数内静态变量，其他编译单元的静态初始化中也能注册
+struct WarmupRegistry {
+    std::mutex                         mutex;
+    std::vector<std::function<void()>> hooks;
+};
+
+static WarmupRegistry& GetWarmupRegistry() {
+    static WarmupRegistry registry;
+    return registry;
+}
+
+void Thread::AddWarmup(std::function<void()> hook) {
+    WarmupRegistry&             registry = GetWarmupRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.hooks.push_back(std::move(hook));
+}
+
+void Thread::RunWarmups() {
+    WarmupRegistry&                    registry = GetWarmupRegistry();
+    std::vector<std::function<void()>> hooks;
+    {
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        hooks = registry.hooks;
+    }
+    for (auto& hook : hooks) {
+        hook();
+    }
+}
+
 //----构造------
 Thread::Thread(std::function<void()> cb)
-    : m_cb(std::move(cb)),
-      m_name("id{" + std::to_string(GetThreadId()) + "}") {
+    : m_name("id{" + std::to_string(GetThreadId()) + "}"),
+      m_cb(std::move(cb)) {
     init();
 }
 
 Thread::Thread(std::function<void()> cb, const std::string& name)
-    : m_cb(std::move(cb)),
-      m_name(name.empty() ? "UNKNOWN" : std::move(name)) {
+    : m_name(name.empty() ? "UNKNOWN" : std::move(name)),
+      m_cb(std::move(cb)) {
     init();
 }
 Thread::Thread(std::function<void()> cb, const std::string&& name)
-    : m_cb(std::move(cb)), m_name(name.empty() ? "UNKNOWN" : name) {
+    : m_name(name.empty() ? "UNKNOWN" : name), m_cb(std::move(cb)) {
     init();
 }
 
 Thread::Thread(std::function<void()>& cb, const std::string& name)
-    : m_cb(std::move(cb)),
-      m_name(name.empty() ? "UNKNOWN" : std::move(name)) {
+    : m_name(name.empty() ? "UNKNOWN" : std::move(name)),
+      m_cb(std::move(cb)) {
     init();
 }
 Thread::Thread(std::function<void()>& cb, const std::string&& name)
-    : m_cb(std::move(cb)), m_name(name.empty() ? "UNKNOWN" : name) {
+    : m_name(name.empty() ? "UNKNOWN" : name), m_cb(std::move(cb)) {
     init();
 }
 
-void Thread::init() {
+Thread::Thread(std::function<void()> cb, const std::string& name,
+               bool wait_started)
+    : m_name(name.empty() ? "UNKNOWN" : name), m_cb(std::move(cb)) {
+    init(wait_started);
+}
+
+void Thread::init(bool wait_started) {
     try {
         m_thread = std::make_unique<std::thread>(&Thread::run, this);
-        std::unique_lock<std::mutex> lock(m_mutex);
-        m_cv.wait(lock, [this] { return m_started.load(); });
     }
     catch (const std::system_error& e) {
         spdlog::get("system_logger")
             ->error("thread create fail : {} ,name = {}", e.what(), m_name);
         throw;
     }
+    if (wait_started) {
+        waitStarted();
+    }
+}
+
+void Thread::waitStarted() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] { return m_started.load(); });
 }
 
 //---构造结束------
@@ -83,25 +130,22 @@ void Thread::join() {
     }
 }
 
+bool Thread::setAffinity(const std::vector<int>& cpus) {
+    return SetThreadAffinity(m_thread->native_handle(), cpus);
+}
+
 void Thread::run() {
     t_thread = this;
     t_thread_name = m_name;
     m_id = GetThreadId();
     pthread_setname_np(pthread_self(), m_name.substr(0, 15).c_str());
-    m_started = true;
-    m_cv.notify_one();
-    m_cb();
-}
-
-//--------自旋锁----------
-void Spinlock::lock() {
-    while (m_flag.test_and_set(std::memory_order_acquire)) {
-        std::this_thread::yield();
+    {
+        //在锁内设置，否则等待方检查完条件、还没休眠时的通知会丢失
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_started = true;
     }
-}
-
-void Spinlock::unlock() {
-    m_flag.clear(std::memory_order_release);
+    m_cv.notify_all();
+    m_cb();
 }
 
 }  // namespace yjcServer